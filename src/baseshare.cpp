@@ -0,0 +1,112 @@
+/** @file    baseshare.cpp
+ *  @brief   Base class for data which is shared between tasks.
+ *  @details This file contains the parts of the share base class which aren't
+ *           inline, including the code that prints the status of every share
+ *           and queue in the system.
+ *
+ *  @date 2026-Oct-18 Rewritten to match JRR's @c BaseShare from the ME507
+ *        support library; prints statistics, list is printed by a loop
+ *
+ *  @copyright This file is copyright 2014 -- 2020 by JR Ridgely and released
+ *    under the Lesser GNU Public License, version 2. It intended for
+ *    educational use only, but its use is not limited thereto. */
+//*****************************************************************************
+
+#include "baseshare.h"
+
+
+// Pointer to the most recently created share or queue, the head of the list
+BaseShare* BaseShare::p_newest = NULL;
+
+
+/** @brief   Construct a base shared data item.
+ *  @details This constructor saves the name of the item and puts it at the
+ *           head of the list of all shares and queues. The first time it
+ *           runs, it also starts the processor's cycle counter, if there is
+ *           one, so the length of critical sections can be measured.
+ *  @param   p_name A name for the share or queue, shown in diagnostic
+ *           printouts (default @c NULL)
+ */
+BaseShare::BaseShare (const char* p_name)
+{
+    name = (p_name == NULL) ? "(unnamed)" : p_name;
+
+    stats.put_count = 0;
+    stats.get_count = 0;
+    stats.last_put_ms = 0;
+    stats.max_critical_cycles = 0;
+
+#if defined (DWT) && defined (CoreDebug)
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0)
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+#endif
+
+    // Shares are created before the scheduler starts, so this is safe
+    p_next = p_newest;
+    p_newest = this;
+}
+
+
+/** @brief   Get a copy of this item's statistics.
+ *  @details The copy is made inside a critical section so the numbers all
+ *           belong together, even if a task is using the share right now.
+ *  @param   copy Filled in with the statistics
+ */
+void BaseShare::get_stats (ShareStats& copy)
+{
+    SHARE_ENTER_CRITICAL ();
+    copy = stats;
+    SHARE_EXIT_CRITICAL ();
+}
+
+
+/** @brief   Print the statistics columns for this share or queue.
+ *  @details The columns are the number of writes and reads, the time in
+ *           milliseconds since the last write (or @c - if it has never been
+ *           written) and the longest critical section in processor cycles.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void BaseShare::print_stats (Print& printer)
+{
+    ShareStats copy;
+    get_stats (copy);
+
+    printer.printf ("%10lu%10lu", (unsigned long)copy.put_count,
+                    (unsigned long)copy.get_count);
+    if (copy.put_count == 0)
+    {
+        printer.printf ("%10s", "-");
+    }
+    else
+    {
+        uint32_t age = share_time_ms () - copy.last_put_ms;
+        printer.printf ("%10lu", (unsigned long)age);
+    }
+    printer.printf ("%10lu", (unsigned long)copy.max_critical_cycles);
+}
+
+
+/** @brief   Print the status of every share and queue in the system.
+ *  @details This function prints a heading and then walks the linked list of
+ *           shares and queues with a loop, asking each one to print its own
+ *           line. Walking the list with a loop rather than having each item
+ *           call the next keeps the stack use the same however many shares
+ *           there are, and no heap memory is used.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void print_all_shares (Print& printer)
+{
+    printer.printf ("%-16s%-8s%10s%10s%10s%10s", "Share/Queue", "Type",
+                    "Puts", "Gets", "Age ms", "Max cyc");
+    printer << endl;
+
+    for (BaseShare* p_share = BaseShare::p_newest; p_share != NULL;
+         p_share = p_share->p_next)
+    {
+        p_share->print_in_list (printer);
+    }
+}
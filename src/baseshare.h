@@ -0,0 +1,224 @@
+/** @file    baseshare.h
+ *  @brief   Base class for data which is shared between tasks.
+ *  @details This file contains a base class for classes which hold data to be
+ *           shared between tasks, such as @c Share<T>. Every share and queue
+ *           is put into a linked list when it is created, so that diagnostic
+ *           code can print the status of all of them. Each item also keeps
+ *           statistics about how it is used: how many times it was written
+ *           and read, how long ago it was last written, the longest time
+ *           spent inside one of its critical sections. These show which
+ *           channels between tasks are busy and which have gone stale.
+ *
+ *  @date 2026-Oct-18 Rewritten to match JRR's @c BaseShare from the ME507
+ *        support library, which taskshare.h needs but which was missing.
+ *        Added access counts and timing statistics; the list of shares is
+ *        printed by a loop instead of recursively
+ *  @date 2026-Oct-18 Critical sections and times go through macros so the
+ *        same shares work in the cyclic executive build
+ *
+ *  @copyright This file is copyright 2014 -- 2020 by JR Ridgely and released
+ *    under the Lesser GNU Public License, version 2. It intended for
+ *    educational use only, but its use is not limited thereto. */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *    IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *    THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *    PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIB-
+ *    UTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ *    OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ *    THE POSSIBILITY OF SUCH DAMAGE. */
+//*****************************************************************************
+
+// This define prevents this .h file from being included more than once
+#ifndef _BASESHARE_H_
+#define _BASESHARE_H_
+
+#include <Arduino.h>
+#include <PrintStream.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+
+
+/** @brief   Begins a section of code which protects shared data.
+ *  @details Under FreeRTOS this is a critical section. In builds with
+ *           @c CLEANBOT_CYCLIC_EXEC each slot runs to completion before the
+ *           next one starts and shares aren't used by interrupts, so there
+ *           is nothing to protect against and no code is generated. Calling
+ *           @c portENTER_CRITICAL() before the scheduler starts would also
+ *           leave interrupts turned off.
+ */
+#ifdef CLEANBOT_CYCLIC_EXEC
+    #define SHARE_ENTER_CRITICAL()
+    #define SHARE_EXIT_CRITICAL()
+#else
+    #define SHARE_ENTER_CRITICAL() portENTER_CRITICAL ()
+    #define SHARE_EXIT_CRITICAL() portEXIT_CRITICAL ()
+#endif
+
+
+/** @brief   Begins a section of code which protects shared data in an ISR.
+ *  @details Under FreeRTOS this masks the interrupts which may use the RTOS,
+ *           so an interrupt of higher priority can't change a share or its
+ *           statistics while a lower priority one is part way through. The
+ *           mask which was in force is kept in a local variable and put back
+ *           by @c SHARE_EXIT_CRITICAL_FROM_ISR(), so the two must be used in
+ *           the same block. In the cyclic executive build no code is made.
+ */
+#ifdef CLEANBOT_CYCLIC_EXEC
+    #define SHARE_ENTER_CRITICAL_FROM_ISR()
+    #define SHARE_EXIT_CRITICAL_FROM_ISR()
+#else
+    #define SHARE_ENTER_CRITICAL_FROM_ISR() \
+        UBaseType_t share_saved_mask = taskENTER_CRITICAL_FROM_ISR ()
+    #define SHARE_EXIT_CRITICAL_FROM_ISR() \
+        taskEXIT_CRITICAL_FROM_ISR (share_saved_mask)
+#endif
+
+
+/** @brief   Returns the time in milliseconds, for share statistics.
+ *  @details This is the RTOS tick count under FreeRTOS and @c millis() in
+ *           the cyclic executive build, where the RTOS tick isn't running.
+ *  @param   in_isr True if called from an interrupt service routine
+ */
+inline uint32_t share_time_ms (bool in_isr = false)
+{
+#ifdef CLEANBOT_CYCLIC_EXEC
+    (void) in_isr;
+    return millis ();
+#else
+    TickType_t ticks = in_isr ? xTaskGetTickCountFromISR ()
+                              : xTaskGetTickCount ();
+    return ticks * portTICK_PERIOD_MS;
+#endif
+}
+
+
+/** @brief   Reads a free running counter of processor clock cycles.
+ *  @details On Cortex-M3 and later processors this is the DWT cycle counter,
+ *           which costs one load to read. On other processors there is no
+ *           such counter and zero is returned, so critical section times
+ *           are not measured.
+ */
+inline uint32_t share_cycle_count (void)
+{
+#if defined (DWT)
+    return DWT->CYCCNT;
+#else
+    return 0;
+#endif
+}
+
+
+/** @brief   Statistics about how one share or queue has been used.
+ *  @details A copy of these is taken inside a critical section so that it
+ *           can be printed without holding up the tasks which use the share.
+ */
+struct ShareStats
+{
+    uint32_t put_count;             ///< Number of times data was written
+    uint32_t get_count;             ///< Number of times data was read
+    uint32_t last_put_ms;           ///< Time of the last write
+    uint32_t max_critical_cycles;   ///< Longest critical section, in cycles
+};
+
+
+/** @brief   Base class for classes of data which can be shared between tasks.
+ *  @details This class holds the name of a share or queue, links it into a
+ *           list of all shares and queues, and keeps its usage statistics.
+ *           Descendent classes update the statistics from inside the
+ *           critical sections they already use to protect their data, so
+ *           keeping the statistics doesn't add any extra critical sections.
+ *           The statistics are fixed size members, so no heap memory is used.
+ */
+class BaseShare
+{
+protected:
+    const char* name;               ///< The name of this share or queue
+    BaseShare* p_next;              ///< Pointer to the next item in the list
+    ShareStats stats;               ///< How this share or queue has been used
+
+    /// Pointer to the most recently created share or queue
+    static BaseShare* p_newest;
+
+    /** @brief   Records a write; call from within a critical section.
+     *  @param   start_cycles Cycle count when the critical section began
+     */
+    void count_put (uint32_t start_cycles)
+    {
+        stats.put_count++;
+        stats.last_put_ms = share_time_ms ();
+        note_critical (start_cycles);
+    }
+
+    /** @brief   Records a write from an ISR; call from within an ISR
+     *           critical section.
+     *  @param   start_cycles Cycle count when the write began
+     */
+    void ISR_count_put (uint32_t start_cycles)
+    {
+        stats.put_count++;
+        stats.last_put_ms = share_time_ms (true);
+        note_critical (start_cycles);
+    }
+
+    /** @brief   Records a read; call from within a critical section.
+     *  @param   start_cycles Cycle count when the critical section began
+     */
+    void count_get (uint32_t start_cycles)
+    {
+        stats.get_count++;
+        note_critical (start_cycles);
+    }
+
+    /** @brief   Records how long a critical section has taken so far.
+     *  @param   start_cycles Cycle count when the critical section began
+     */
+    void note_critical (uint32_t start_cycles)
+    {
+        uint32_t cycles = share_cycle_count () - start_cycles;
+        if (cycles > stats.max_critical_cycles)
+        {
+            stats.max_critical_cycles = cycles;
+        }
+    }
+
+    // Prints the statistics columns which are the same for every kind of item
+    void print_stats (Print& printer);
+
+public:
+    // Constructor which puts this item into the list of all shares and queues
+    BaseShare (const char* p_name = NULL);
+
+    /** @brief   Print the status of this share or queue on one line.
+     *  @details Each descendent class prints its name, what kind of item it
+     *           is and its statistics. It only prints its own line; the list
+     *           is walked by @c print_all_shares().
+     *  @param   printer Reference to a serial device on which to print
+     */
+    virtual void print_in_list (Print& printer) = 0;
+
+    /** @brief   Get a copy of this item's statistics.
+     *  @param   copy Filled in with the statistics
+     */
+    void get_stats (ShareStats& copy);
+
+    /** @brief   Get the name of this share or queue.
+     */
+    const char* get_name (void) const
+    {
+        return name;
+    }
+
+    // Prints every share and queue in the system
+    friend void print_all_shares (Print& printer);
+};
+
+
+// Prints a table of the status of every share and queue in the system
+void print_all_shares (Print& printer);
+
+#endif  // _BASESHARE_H_
@@ -0,0 +1,227 @@
+/** @file   coverage_grid.cpp
+ *  @brief  This file contains the definitions of the grid which keeps track
+ *          of the UV dose each part of the floor has had.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ */
+
+#include <math.h>
+#include <string.h>
+#include "coverage_grid.h"
+
+/// Largest count a cell can hold
+static const uint8_t MAX_DOSE = 255;
+
+
+/** @brief   Finds the cells whose middles are under the lamp.
+ *  @details Only the cells in the box around the lamp are checked, at most
+ *           four by four for the default lamp, by measuring each cell's
+ *           middle along and across the robot.
+ */
+uint8_t lamp_cells(const CoverageParams& params, float x_mm, float y_mm,
+                   float heading, float ahead_mm, uint16_t* p_cells)
+{
+    float along_x = cosf(heading);
+    float along_y = sinf(heading);
+    float forward = params.lamp_offset_mm + ahead_mm;
+    float center_x = x_mm + forward * along_x - params.origin_x_mm;
+    float center_y = y_mm + forward * along_y - params.origin_y_mm;
+    float half_length = 0.5f * params.lamp_length_mm;
+    float half_width = 0.5f * params.lamp_width_mm;
+
+    // Box around the lamp, in cells
+    float reach_x = half_length * fabsf(along_x) + half_width * fabsf(along_y);
+    float reach_y = half_length * fabsf(along_y) + half_width * fabsf(along_x);
+    int16_t first_column = (int16_t)ceilf((center_x - reach_x)
+                                          / COVERAGE_CELL_MM - 0.5f);
+    int16_t last_column = (int16_t)floorf((center_x + reach_x)
+                                          / COVERAGE_CELL_MM - 0.5f);
+    int16_t first_row = (int16_t)ceilf((center_y - reach_y)
+                                       / COVERAGE_CELL_MM - 0.5f);
+    int16_t last_row = (int16_t)floorf((center_y + reach_y)
+                                       / COVERAGE_CELL_MM - 0.5f);
+    if (first_column < 0) first_column = 0;
+    if (first_row < 0) first_row = 0;
+    if (last_column >= COVERAGE_COLUMNS) last_column = COVERAGE_COLUMNS - 1;
+    if (last_row >= COVERAGE_ROWS) last_row = COVERAGE_ROWS - 1;
+
+    uint8_t found = 0;
+    for (int16_t row = first_row; row <= last_row; row++)
+    {
+        float dy = (row + 0.5f) * COVERAGE_CELL_MM - center_y;
+        for (int16_t column = first_column; column <= last_column; column++)
+        {
+            float dx = (column + 0.5f) * COVERAGE_CELL_MM - center_x;
+            if (fabsf(dx * along_x + dy * along_y) > half_length
+                || fabsf(dy * along_x - dx * along_y) > half_width)
+            {
+                continue;
+            }
+            if (found < COVERAGE_MAX_LAMP_CELLS)
+            {
+                p_cells[found++] = (uint16_t)(row * COVERAGE_COLUMNS + column);
+            }
+        }
+    }
+    return found;
+}
+
+/** @brief   Works out the speed which gives a dose in one pass of the lamp.
+ *  @details A cell is under the lamp while the robot drives the lamp's
+ *           length, so @p needed counts take that length at
+ *           <tt>lamp_length / (needed * COVERAGE_DOSE_MS)</tt>.
+ */
+uint8_t dose_speed_percent(const CoverageParams& params, uint8_t needed)
+{
+    if (needed == 0)
+    {
+        return 100;
+    }
+    uint32_t speed_mm_s = (uint32_t)params.lamp_length_mm * 1000
+                          / ((uint32_t)needed * COVERAGE_DOSE_MS);
+    uint32_t percent = speed_mm_s * 100 / params.full_speed_mm_s;
+    if (percent < params.min_percent)
+    {
+        return params.min_percent;
+    }
+    return percent > 100 ? 100 : (uint8_t)percent;
+}
+
+
+/** @brief      Constructor which makes a grid with no dose anywhere
+ */
+CoverageGrid::CoverageGrid(const CoverageParams& coverage_params)
+    : params(coverage_params)
+{
+    clear();
+}
+
+/** @brief      Throws away every dose and starts again
+ */
+void CoverageGrid::clear()
+{
+    memset(doses, 0, sizeof(doses));
+    touched = 0;
+    dosed = 0;
+    deficit = 0;
+    delivered = 0;
+    lamp_periods = 0;
+    window_delivered = 0;
+    window_start = 0;
+    rate = 0.0f;
+    off_grid = 0;
+}
+
+/** @brief      Adds the dose from the lamp at the latest odometry
+ *  @details    The counts of cells touched and done, and the counts still
+ *              needed, are changed as each cell's dose goes up, so none of
+ *              them needs the whole grid to be searched.
+ */
+void CoverageGrid::expose(const Odometry& odometry, bool lamp_on,
+                          uint8_t periods)
+{
+    if (!lamp_on || periods == 0)
+    {
+        return;
+    }
+    lamp_periods += periods;
+    if (lamp_periods - window_start >= COVERAGE_RATE_PERIODS)
+    {
+        float latest = (float)(delivered - window_delivered)
+                       / (lamp_periods - window_start);
+        rate = window_start == 0 ? latest : 0.5f * (rate + latest);
+        window_delivered = delivered;
+        window_start = lamp_periods;
+    }
+
+    uint16_t cells[COVERAGE_MAX_LAMP_CELLS];
+    uint8_t count = lamp_cells(params, odometry.x_mm, odometry.y_mm,
+                               odometry.heading, 0.0f, cells);
+    if (count == 0)
+    {
+        off_grid++;
+        return;
+    }
+
+    const uint8_t required = params.required_dose;
+    for (uint8_t index = 0; index < count; index++)
+    {
+        uint8_t& dose = doses[cells[index]];
+        if (dose == 0)
+        {
+            touched++;
+            deficit += required;
+        }
+        uint8_t added = periods < MAX_DOSE - dose ? periods
+                                                  : MAX_DOSE - dose;
+        if (dose < required)
+        {
+            uint8_t useful = added < required - dose ? added
+                                                     : required - dose;
+            deficit -= useful;
+            delivered += useful;
+            if (dose + useful == required)
+            {
+                dosed++;
+            }
+        }
+        dose += added;
+    }
+}
+
+/** @brief      Chooses the speed for the floor just ahead of the lamp
+ */
+uint8_t CoverageGrid::speed_percent(const Odometry& odometry) const
+{
+    uint16_t cells[COVERAGE_MAX_LAMP_CELLS];
+    uint8_t count = lamp_cells(params, odometry.x_mm, odometry.y_mm,
+                               odometry.heading,
+                               0.5f * params.lamp_length_mm, cells);
+
+    uint8_t needed = 0;
+    for (uint8_t index = 0; index < count; index++)
+    {
+        uint8_t dose = doses[cells[index]];
+        if (dose < params.required_dose
+            && params.required_dose - dose > needed)
+        {
+            needed = params.required_dose - dose;
+        }
+    }
+    return dose_speed_percent(params, needed);
+}
+
+/** @brief      Estimates how long it will take to finish the floor seen
+ */
+uint32_t CoverageGrid::completion_ms() const
+{
+    if (deficit == 0 && touched > 0)
+    {
+        return 0;
+    }
+
+    // Until the first rate has been measured, use the rate so far
+    float useful = window_start ? rate
+                   : lamp_periods ? (float)delivered / lamp_periods : 0.0f;
+    float time_ms = deficit / useful * COVERAGE_DOSE_MS;
+    return useful <= 0.0f || time_ms > (float)UINT32_MAX
+           ? UINT32_MAX : (uint32_t)time_ms;
+}
+
+/** @brief      Returns the dose of the cell under a point
+ */
+uint8_t CoverageGrid::dose_at(float x_mm, float y_mm) const
+{
+    float column = floorf((x_mm - params.origin_x_mm) / COVERAGE_CELL_MM);
+    float row = floorf((y_mm - params.origin_y_mm) / COVERAGE_CELL_MM);
+    if (column < 0.0f || column >= COVERAGE_COLUMNS
+        || row < 0.0f || row >= COVERAGE_ROWS)
+    {
+        return 0;
+    }
+    return doses[(uint16_t)row * COVERAGE_COLUMNS + (uint16_t)column];
+}
@@ -0,0 +1,181 @@
+/** @file   coverage_grid.h
+ *  @brief  This file contains a map of the floor which keeps track of how
+ *          much UV light each part of it has had, so the CleanBot knows
+ *          where it has disinfected and how long it has left.
+ *  @details The floor is cut into square cells of @c COVERAGE_CELL_MM on a
+ *           side, each with an 8 bit dose counter. Every @c COVERAGE_DOSE_MS
+ *           that the lamp is on, each cell whose middle is under the lamp
+ *           gets one more count, found from the odometry. A cell which has
+ *           had @c required_dose counts is done.
+ *
+ *           The same grid sets the speed. The lamp only covers a short strip
+ *           of floor, so the time a cell spends under it is the lamp's length
+ *           divided by the speed. Ahead of the lamp, the cell which still
+ *           needs the most dose sets the speed which gives it exactly that
+ *           dose in one pass. New floor is driven slowly, floor which is
+ *           done is driven at full speed, and no time is spent giving cells
+ *           more than they need.
+ *
+ *           The counts of cells seen, cells done and counts still needed are
+ *           kept up to date as the grid is exposed, so coverage and the time
+ *           left can be asked for at any time without searching the grid.
+ *           The grid is a fixed size array, 4 KB for 3.2 m by 3.2 m, so no
+ *           heap memory is used. The lamp itself is only a flag passed in,
+ *           so @c uv_sim can measure how long a dose takes over many runs,
+ *           and @c arena can give every robot in a fleet its own grid.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ */
+
+
+#ifndef COVERAGE_GRID_H
+#define COVERAGE_GRID_H
+
+#include <stdint.h>
+#include "odometry.h"
+
+/// Number of columns of cells, along the odometry's x axis
+const uint8_t COVERAGE_COLUMNS = 64;
+
+/// Number of rows of cells, along the odometry's y axis
+const uint8_t COVERAGE_ROWS = 64;
+
+/// Length of each side of a cell, in millimeters
+const uint16_t COVERAGE_CELL_MM = 50;
+
+/// Time under the lamp which adds one count to a cell's dose
+const uint16_t COVERAGE_DOSE_MS = 10;
+
+/// Dose periods with the lamp on over which the delivery rate is measured
+const uint16_t COVERAGE_RATE_PERIODS = 500;
+
+/// Most cells whose middles can be under the lamp at once
+const uint8_t COVERAGE_MAX_LAMP_CELLS = 16;
+
+/** @brief   Tunable settings for the grid and the lamp.
+ *  @details The grid's corner is placed so that the CleanBot starts in the
+ *           middle of it.
+ */
+struct CoverageParams
+{
+    uint8_t required_dose = 50;     ///< Counts each cell needs to be done
+    uint16_t lamp_width_mm = 120;   ///< Size of the lamp across the robot
+    uint16_t lamp_length_mm = 60;   ///< Size of the lamp along the robot
+    int16_t lamp_offset_mm = 0;     ///< Lamp's middle ahead of the axle
+    uint16_t full_speed_mm_s = 400; ///< Ground speed at 100 % speed
+    uint8_t min_percent = 25;       ///< Slowest speed the drive logic can use
+    int16_t origin_x_mm = -1600;    ///< Odometry x of the grid's corner
+    int16_t origin_y_mm = -1600;    ///< Odometry y of the grid's corner
+};
+
+/** @brief   Finds the cells whose middles are under the lamp.
+ *  @details The lamp is a rectangle centered @c lamp_offset_mm plus
+ *           @p ahead_mm in front of the axle. Cells off the grid are left
+ *           out.
+ *
+ *  @param   params      Size and place of the lamp and grid
+ *  @param   x_mm        Position of the middle of the axle
+ *  @param   y_mm        Position of the middle of the axle
+ *  @param   heading     Direction of travel in radians
+ *  @param   ahead_mm    How far ahead of where it is to put the lamp
+ *  @param   p_cells     Filled with the index, row times
+ *                       @c COVERAGE_COLUMNS plus column, of each cell; must
+ *                       have room for @c COVERAGE_MAX_LAMP_CELLS
+ *  @return  Number of cells found
+ */
+uint8_t lamp_cells(const CoverageParams& params, float x_mm, float y_mm,
+                   float heading, float ahead_mm, uint16_t* p_cells);
+
+/** @brief   Works out the speed which gives a dose in one pass of the lamp.
+ *  @param   params      Size of the lamp and speed limits
+ *  @param   needed      Counts still needed by the neediest cell ahead
+ *  @return  Percentage of the usual speeds to use
+ */
+uint8_t dose_speed_percent(const CoverageParams& params, uint8_t needed);
+
+/** @brief   Class which keeps the UV dose of every cell of the floor.
+ */
+class CoverageGrid
+{
+private:
+
+CoverageParams params;              ///< Tunable settings
+uint8_t doses[COVERAGE_ROWS * COVERAGE_COLUMNS];    ///< Counts per cell
+uint16_t touched;                   ///< Cells which have had any dose
+uint16_t dosed;                     ///< Cells which have had enough
+uint32_t deficit;                   ///< Counts still needed by touched cells
+uint32_t delivered;                 ///< Counts which went toward a dose
+uint32_t lamp_periods;              ///< Dose periods with the lamp on
+uint32_t window_delivered;          ///< delivered when the rate was measured
+uint32_t window_start;              ///< lamp_periods at the same time
+float rate;                         ///< Useful counts per dose period lately
+uint32_t off_grid;                  ///< Exposures with no cell under the lamp
+
+public:
+
+/** @brief      Constructor which makes a grid with no dose anywhere
+ *  @param      coverage_params Tunable settings
+ */
+CoverageGrid(const CoverageParams& coverage_params = CoverageParams());
+
+/** @brief      Throws away every dose and starts again
+ */
+void clear();
+
+/** @brief      Adds the dose from the lamp at the latest odometry
+ *  @details    Call every @c COVERAGE_DOSE_MS, or with the number of dose
+ *              periods which have gone by. Each cell's count stops at 255.
+ *
+ *  @param      odometry    Position of the CleanBot
+ *  @param      lamp_on     True if the lamp is lit
+ *  @param      periods     Number of dose periods since the last call
+ */
+void expose(const Odometry& odometry, bool lamp_on, uint8_t periods = 1);
+
+/** @brief      Chooses the speed for the floor just ahead of the lamp
+ *  @details    The cells under the lamp half its length further on are
+ *              the ones which will spend the most time under it from here,
+ *              so the one of those needing the most dose sets the speed.
+ *
+ *  @param      odometry    Position of the CleanBot
+ *  @return     Percentage of the usual speeds to use, from
+ *              @c min_percent to 100
+ */
+uint8_t speed_percent(const Odometry& odometry) const;
+
+/** @brief      Estimates how long it will take to finish the floor seen
+ *  @details    The counts still needed are divided by the rate at which
+ *              counts have lately gone toward a dose with the lamp on. The
+ *              rate is measured every @c COVERAGE_RATE_PERIODS and averaged
+ *              with the ones before, so as the floor fills up and more of
+ *              the lamp falls on cells which are done, the estimate grows.
+ *  @return     Milliseconds of cleaning left, zero once every cell seen
+ *              is done, or @c UINT32_MAX before any dose has been delivered
+ */
+uint32_t completion_ms() const;
+
+/** @brief      Returns the dose of the cell under a point
+ *  @return     Counts in that cell, or zero if it is off the grid
+ */
+uint8_t dose_at(float x_mm, float y_mm) const;
+
+/** @brief      Returns the percentage of the cells seen which are done
+ */
+uint8_t coverage_percent() const
+{
+    return touched ? (uint8_t)((uint32_t)dosed * 100 / touched) : 0;
+}
+
+uint16_t get_touched() const { return touched; }
+uint16_t get_dosed() const { return dosed; }
+uint32_t get_deficit() const { return deficit; }
+uint32_t get_lamp_ms() const { return lamp_periods * COVERAGE_DOSE_MS; }
+uint32_t get_off_grid() const { return off_grid; }
+
+}; //end class CoverageGrid
+
+#endif //end if: define coverage grid declarations
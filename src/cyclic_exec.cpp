@@ -0,0 +1,186 @@
+/** @file   cyclic_exec.cpp
+ *  @brief  This file contains the definition of the time-triggered cyclic
+ *          executive.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ *  @date   18 Oct 2026     Overruns and start lateness measured from the
+ *                          tick interrupt
+ */
+
+#include <PrintStream.h>
+#include "cyclic_exec.h"
+
+// Number of timer ticks, counted by the timer interrupt
+volatile uint32_t CyclicExecutive::ticks = 0;
+
+// Cycle count when the timer interrupt saw the latest tick
+volatile uint32_t CyclicExecutive::tick_cycles = 0;
+
+
+/** @brief      Constructor which takes the schedule table
+ */
+CyclicExecutive::CyclicExecutive(const CyclicSlot* slots,
+                                 SlotTiming* timings, uint8_t count,
+                                 IdleMeter& idle)
+    : p_slots(slots), p_timings(timings), slot_count(count), p_timer(NULL),
+      idle_meter(idle), frames(0), overruns(0), skipped(0),
+      max_start_cycles(0)
+{
+    for (uint8_t index = 0; index < slot_count; index++)
+    {
+        p_timings[index] = SlotTiming();
+    }
+}
+
+/** @brief      Counts a timer tick and notes when it came
+ */
+void CyclicExecutive::tick()
+{
+    tick_cycles = share_cycle_count();
+    ticks++;
+}
+
+/** @brief      Starts the timer which marks the start of each frame
+ */
+void CyclicExecutive::begin(TIM_TypeDef* p_instance)
+{
+    p_timer = new HardwareTimer(p_instance);
+    p_timer->setOverflow(CYCLE_FRAME_US, MICROSEC_FORMAT);
+    p_timer->attachInterrupt(tick);
+    p_timer->resume();
+}
+
+/** @brief      Runs the schedule forever
+ *  @details    While waiting for the next tick the processor sleeps with
+ *              @c WFI, and the time spent waiting is given to the idle
+ *              meter. How late each frame starts is measured in cycles from
+ *              the time the timer interrupt saw its tick, so lateness of any
+ *              length is measured correctly; it doesn't include the few
+ *              cycles it takes to enter the interrupt. A frame overran if
+ *              the next tick has already come when its last slot is done,
+ *              even if it finished well before the tick after that.
+ */
+void CyclicExecutive::run()
+{
+    uint32_t done = ticks;
+    uint16_t frame = 0;
+
+    for (;;)
+    {
+        // Wait for the tick which starts the next frame
+        uint32_t wait_start = share_cycle_count();
+        uint32_t now;
+        uint32_t tick_at;
+        // Interrupts are masked while checking, so a tick can't arrive
+        // between the check and the WFI; a pending one still wakes it. The
+        // tick count and its time are read together for the same reason
+        for (;;)
+        {
+            __disable_irq();
+            if (ticks != done)
+            {
+                now = ticks;
+                tick_at = tick_cycles;
+                __enable_irq();
+                break;
+            }
+            __WFI();
+            __enable_irq();
+        }
+        uint32_t start_cycles = share_cycle_count();
+        idle_meter.add_idle(start_cycles - wait_start);
+
+        if (start_cycles - tick_at > max_start_cycles)
+        {
+            max_start_cycles = start_cycles - tick_at;
+        }
+
+        // If more than one tick has gone by, the frames in between were
+        // lost; skip them so every slot stays in its place in the cycle
+        if (now - done > 1)
+        {
+            skipped += now - done - 1;
+            frame = (frame + now - done - 1) % CYCLE_FRAMES;
+        }
+        done = now;
+
+        for (uint8_t index = 0; index < slot_count; index++)
+        {
+            const CyclicSlot& slot = p_slots[index];
+            if (frame % slot.period != slot.offset)
+            {
+                continue;
+            }
+
+            uint32_t begin = share_cycle_count();
+            slot.p_step();
+            uint32_t cycles = share_cycle_count() - begin;
+
+            SlotTiming& timing = p_timings[index];
+            timing.runs++;
+            timing.last_cycles = cycles;
+            timing.total_cycles += cycles;
+            if (cycles > timing.max_cycles)
+            {
+                timing.max_cycles = cycles;
+            }
+            if (cycles / (SystemCoreClock / 1000000) > slot.budget_us)
+            {
+                timing.over_budget++;
+            }
+        }
+
+        // A tick which came while the slots ran means this frame ran into
+        // the next one
+        if (ticks != done)
+        {
+            overruns++;
+        }
+
+        frames++;
+        frame = (frame + 1) % CYCLE_FRAMES;
+    }
+}
+
+/** @brief      Prints the measured time of each slot and of the frames
+ *  @details    Times are in microseconds. The start latency is how long
+ *              after its tick the latest frame began, which is the jitter
+ *              of every slot's start time.
+ */
+void CyclicExecutive::print(Print& printer) const
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000;
+
+    printer.printf("%-16s%8s%10s%10s%10s%10s%8s", "Slot", "Period",
+                   "Runs", "Last us", "Mean us", "Max us", "Budget");
+    printer << endl;
+    for (uint8_t index = 0; index < slot_count; index++)
+    {
+        const CyclicSlot& slot = p_slots[index];
+        const SlotTiming& timing = p_timings[index];
+        uint32_t mean = timing.runs == 0 ? 0
+            : (uint32_t)(timing.total_cycles / timing.runs / cycles_per_us);
+        printer.printf("%-16s%8u%10lu%10lu%10lu%10lu%8u", slot.name,
+                       (unsigned)slot.period, (unsigned long)timing.runs,
+                       (unsigned long)(timing.last_cycles / cycles_per_us),
+                       (unsigned long)mean,
+                       (unsigned long)(timing.max_cycles / cycles_per_us),
+                       (unsigned)slot.budget_us);
+        if (timing.over_budget > 0)
+        {
+            printer.printf("  over %lu times",
+                           (unsigned long)timing.over_budget);
+        }
+        printer << endl;
+    }
+    printer.printf("Frames: %lu, overran %lu, skipped %lu, "
+                   "latest start %lu us",
+                   (unsigned long)frames, (unsigned long)overruns,
+                   (unsigned long)skipped,
+                   (unsigned long)(max_start_cycles / cycles_per_us));
+    printer << endl;
+}
@@ -0,0 +1,185 @@
+/** @file   cyclic_exec.h
+ *  @brief  This file contains a time-triggered cyclic executive, which runs
+ *          the CleanBot's task bodies from a fixed schedule instead of under
+ *          FreeRTOS.
+ *  @details One hardware timer divides time into minor frames of
+ *           @c CYCLE_FRAME_US. The schedule is a table of slots, each of
+ *           which runs one task's step function every @c period frames,
+ *           starting at frame @c offset, for a major cycle of
+ *           @c CYCLE_FRAMES frames. Each slot has a time budget, and
+ *           @c CYCLE_SCHEDULE_FITS() checks at compile time that no frame's
+ *           slots add up to more than the frame. At run time the executive
+ *           measures how long each slot really takes, how late each frame
+ *           starts and how many frames overran, so the budgets can be
+ *           checked against the hardware.
+ *
+ *           The executive is used in builds with @c CLEANBOT_CYCLIC_EXEC
+ *           defined; other builds run the same step functions as FreeRTOS
+ *           tasks.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ *  @date    18 Oct 2026 Overruns counted whenever a tick is pending at the
+ *                       end of a frame; start lateness timed in cycles from
+ *                       the tick interrupt
+ */
+
+
+#ifndef CYCLIC_EXEC_H
+#define CYCLIC_EXEC_H
+
+#include <Arduino.h>
+#include "deadline_monitor.h"
+
+/// Length of one minor frame in microseconds
+const uint32_t CYCLE_FRAME_US = 1000;
+
+/// Number of minor frames in the major cycle, which repeats every 100 ms
+const uint16_t CYCLE_FRAMES = 100;
+
+/// Time in each frame kept free for the timer interrupt and other ISRs
+const uint32_t CYCLE_MARGIN_US = 100;
+
+/** @brief   One entry in the schedule table.
+ */
+struct CyclicSlot
+{
+    void (*p_step)(void);           ///< Task body to run
+    const char* name;               ///< Name shown in diagnostic printouts
+    uint16_t period;                ///< Frames between runs
+    uint16_t offset;                ///< First frame in which it runs
+    uint16_t budget_us;             ///< Longest time the step may take
+};
+
+/** @brief   What the executive has measured about one slot.
+ */
+struct SlotTiming
+{
+    uint32_t runs;                  ///< Number of times the slot ran
+    uint32_t last_cycles;           ///< Time taken by the last run
+    uint32_t max_cycles;            ///< Longest time taken
+    uint64_t total_cycles;          ///< Time taken by all runs
+    uint32_t over_budget;           ///< Runs which took longer than budget
+};
+
+/** @brief      Adds up the budgets of the slots which run in one frame
+ *  @param      p_slots The schedule table
+ *  @param      count   Number of slots in the table
+ *  @param      frame   Frame number within the major cycle
+ *  @return     Total budget of that frame's slots in microseconds
+ */
+constexpr uint32_t cycle_frame_load(const CyclicSlot* p_slots, size_t count,
+                                    uint16_t frame)
+{
+    return count == 0 ? 0
+        : (frame % p_slots[0].period == p_slots[0].offset
+               ? p_slots[0].budget_us : 0)
+          + cycle_frame_load(p_slots + 1, count - 1, frame);
+}
+
+/** @brief      Returns the larger of two loads
+ */
+constexpr uint32_t cycle_larger(uint32_t first, uint32_t second)
+{
+    return first > second ? first : second;
+}
+
+/** @brief      Finds the busiest frame of the major cycle
+ *  @return     Total budget of the busiest frame's slots in microseconds
+ */
+constexpr uint32_t cycle_worst_load(const CyclicSlot* p_slots, size_t count,
+                                    uint16_t frame = 0)
+{
+    return frame >= CYCLE_FRAMES ? 0
+        : cycle_larger(cycle_frame_load(p_slots, count, frame),
+                       cycle_worst_load(p_slots, count, frame + 1));
+}
+
+/** @brief      Checks that every slot's period fits the major cycle
+ *  @return     True if each period divides the major cycle and each offset
+ *              is less than its period
+ */
+constexpr bool cycle_periods_fit(const CyclicSlot* p_slots, size_t count)
+{
+    return count == 0
+        || (p_slots[0].period > 0
+            && CYCLE_FRAMES % p_slots[0].period == 0
+            && p_slots[0].offset < p_slots[0].period
+            && cycle_periods_fit(p_slots + 1, count - 1));
+}
+
+/** @brief   Fails the build if a schedule table can overrun a frame.
+ *  @param   table A @c constexpr array of @c CyclicSlot
+ */
+#define CYCLE_SCHEDULE_FITS(table)                                            \
+    static_assert (cycle_periods_fit (table, sizeof (table)                   \
+                                      / sizeof (table[0])),                   \
+                   "each slot's period must divide CYCLE_FRAMES");            \
+    static_assert (cycle_worst_load (table, sizeof (table)                    \
+                                     / sizeof (table[0]))                     \
+                   <= CYCLE_FRAME_US - CYCLE_MARGIN_US,                       \
+                   "a frame's slot budgets are longer than the frame")
+
+
+/** @brief   Class which runs a schedule table from a hardware timer.
+ */
+class CyclicExecutive
+{
+private:
+
+const CyclicSlot* p_slots;          ///< The schedule table
+SlotTiming* p_timings;              ///< Measurements for each slot
+uint8_t slot_count;                 ///< Number of slots in the table
+HardwareTimer* p_timer;             ///< Timer which starts each frame
+IdleMeter& idle_meter;              ///< Where time spent waiting is counted
+uint32_t frames;                    ///< Frames run
+uint32_t overruns;                  ///< Frames which ran into the next one
+uint32_t skipped;                   ///< Frames which never started
+uint32_t max_start_cycles;          ///< Latest start of a frame after its tick
+
+/// Number of timer ticks, counted by the timer interrupt
+static volatile uint32_t ticks;
+
+/// Cycle count when the timer interrupt saw the latest tick
+static volatile uint32_t tick_cycles;
+
+// Counts a timer tick and notes when it came
+static void tick();
+
+public:
+
+/** @brief      Constructor which takes the schedule table
+ *
+ *  @param      slots       The schedule table
+ *  @param      timings     Array with one entry per slot for measurements
+ *  @param      count       Number of slots in the table
+ *  @param      idle        Meter to give the time spent waiting to
+ */
+CyclicExecutive(const CyclicSlot* slots, SlotTiming* timings, uint8_t count,
+                IdleMeter& idle);
+
+/** @brief      Starts the timer which marks the start of each frame
+ *  @param      p_instance  Timer to use; it must not be used for anything
+ *                          else
+ */
+void begin(TIM_TypeDef* p_instance);
+
+/** @brief      Runs the schedule forever
+ *  @details    At each tick, the slots due in that frame are run in the
+ *              order they appear in the table. If the next tick has already
+ *              come when a frame's slots are done, the frame overran; any
+ *              frames which were missed altogether are skipped, so the
+ *              schedule keeps time.
+ */
+void run();
+
+/** @brief      Prints the measured time of each slot and of the frames
+ */
+void print(Print& printer) const;
+
+}; //end class CyclicExecutive
+
+#endif //end if: define cyclic executive declarations
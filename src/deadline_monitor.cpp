@@ -0,0 +1,274 @@
+/** @file   deadline_monitor.cpp
+ *  @brief  This file contains the definitions of the deadline monitor and
+ *          the drive train freshness guard.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ *  @date   18 Oct 2026     Early check ins and the idle time meter
+ *  @date   18 Oct 2026     Freshness guard times the drive command's sequence
+ *                          number
+ */
+
+#include <PrintStream.h>
+#if (defined STM32L4xx || defined STM32F4xx)
+    #include <STM32FreeRTOS.h>
+#endif
+#include "deadline_monitor.h"
+
+/// Lateness allowed for jitter: one RTOS tick
+static const uint32_t TICK_SLACK_US = 1000;
+
+/// Age reported for a task which has never checked in
+static const uint32_t NEVER_US = 0xFFFFFFFF;
+
+/// Longest gap between calls to IdleMeter::idle() which still counts as idle
+static const uint32_t IDLE_GAP_CYCLES = 500;
+
+// The most recently created deadline, the head of the list
+Deadline* Deadline::p_newest = NULL;
+
+
+/** @brief      Constructor which sets up the deadline for one task
+ *  @details    Deadlines are created before the scheduler starts, so putting
+ *              this one into the list needs no protection.
+ *
+ *  @param      p_name      Name of the task, shown in diagnostic printouts
+ *  @param      period_ms   Period of the task in milliseconds
+ */
+Deadline::Deadline(const char* p_name, uint32_t period_ms)
+    : name(p_name), period_us(period_ms * 1000), slack_us(TICK_SLACK_US),
+      last_check_in_us(0), check_ins(0), missed(0), max_late_us(0),
+      max_early_us(0)
+{
+    p_next = p_newest;
+    p_newest = this;
+}
+
+/** @brief      Called by the task once every period
+ *  @details    The time since the previous check in is compared with the
+ *              period. Any lateness is recorded, and each whole period which
+ *              went by without a check in counts as a miss.
+ */
+void Deadline::check_in()
+{
+    uint32_t now = micros();
+
+    if (check_ins > 0)
+    {
+        uint32_t gap = now - last_check_in_us;
+        if (gap > period_us)
+        {
+            uint32_t late = gap - period_us;
+            if (late > max_late_us)
+            {
+                max_late_us = late;
+            }
+            if (late > slack_us)
+            {
+                missed += (late - slack_us) / period_us + 1;
+            }
+        }
+        else if (period_us - gap > max_early_us)
+        {
+            max_early_us = period_us - gap;
+        }
+    }
+
+    last_check_in_us = now;
+    check_ins++;
+}
+
+/** @brief      Returns the microseconds since the task last checked in
+ */
+uint32_t Deadline::age_us() const
+{
+    if (check_ins == 0)
+    {
+        return NEVER_US;
+    }
+    return micros() - last_check_in_us;
+}
+
+/** @brief      Prints this deadline's statistics on one line
+ *  @details    The columns are the period, the number of check ins, the
+ *              number of missed periods, the worst lateness, the most a
+ *              check in came early and the time since the last check in, all
+ *              times in microseconds. Late and early together give the
+ *              task's jitter.
+ */
+void Deadline::print_in_list(Print& printer)
+{
+    printer.printf("%-16s%10lu%10lu%8lu%10lu%10lu", name,
+                   (unsigned long)period_us, (unsigned long)check_ins,
+                   (unsigned long)missed, (unsigned long)max_late_us,
+                   (unsigned long)max_early_us);
+    uint32_t age = age_us();
+    if (age == NEVER_US)
+    {
+        printer.printf("%10s", "-");
+    }
+    else
+    {
+        printer.printf("%10lu", (unsigned long)age);
+    }
+    printer << endl;
+}
+
+/** @brief      Prints a table of every deadline in the system
+ *  @param      printer Reference to a serial device on which to print
+ */
+void print_all_deadlines(Print& printer)
+{
+    printer.printf("%-16s%10s%10s%8s%10s%10s%10s", "Task", "Period us",
+                   "Runs", "Missed", "Late us", "Early us", "Age us");
+    printer << endl;
+
+    for (Deadline* p_deadline = Deadline::p_newest; p_deadline != NULL;
+         p_deadline = p_deadline->p_next)
+    {
+        p_deadline->print_in_list(printer);
+    }
+}
+
+
+/** @brief      Constructor which sets the freshness limits
+ *  @details    Until the first message arrives the data counts as stale, so
+ *              the drive train starts out stopped.
+ */
+FreshnessGuard::FreshnessGuard(uint32_t reduce_after_ms,
+                               uint32_t stop_after_ms)
+    : reduce_after_us(reduce_after_ms * 1000),
+      stop_after_us(stop_after_ms * 1000), last_sequence(0),
+      last_fresh_us(0), mode(DRIVE_STOPPED), reduced_count(0),
+      stopped_count(0)
+{
+}
+
+/** @brief      Checks the age of the data and chooses the drive mode
+ *  @details    A sequence number different from the last one means a new
+ *              message, which restarts the age. Each change into a worse
+ *              mode is counted so the diagnostics show how often the drive
+ *              train had to be held back.
+ */
+DriveMode FreshnessGuard::update(uint32_t sequence)
+{
+    uint32_t now = micros();
+    if (sequence != last_sequence)
+    {
+        last_sequence = sequence;
+        last_fresh_us = now;
+    }
+
+    uint32_t age = (last_sequence == 0) ? NEVER_US : now - last_fresh_us;
+    DriveMode new_mode;
+    if (age > stop_after_us)
+    {
+        new_mode = DRIVE_STOPPED;
+    }
+    else if (age > reduce_after_us)
+    {
+        new_mode = DRIVE_REDUCED;
+    }
+    else
+    {
+        new_mode = DRIVE_NORMAL;
+    }
+
+    if (new_mode > mode)
+    {
+        if (new_mode == DRIVE_REDUCED)
+        {
+            reduced_count++;
+        }
+        else
+        {
+            stopped_count++;
+        }
+    }
+    mode = new_mode;
+    return mode;
+}
+
+/** @brief      Changes wheel speeds to suit the current drive mode
+ */
+void FreshnessGuard::limit(int16_t& left, int16_t& right) const
+{
+    if (mode == DRIVE_REDUCED)
+    {
+        left /= 2;
+        right /= 2;
+    }
+    else if (mode == DRIVE_STOPPED)
+    {
+        left = 0;
+        right = 0;
+    }
+}
+
+/** @brief      Prints the current mode and how often it has degraded
+ */
+void FreshnessGuard::print(Print& printer) const
+{
+    const char* names[] = {"normal", "reduced", "stopped"};
+    printer.printf("Drive mode: %s, slowed %lu times, stopped %lu times",
+                   names[mode], (unsigned long)reduced_count,
+                   (unsigned long)stopped_count);
+    printer << endl;
+}
+
+
+/** @brief      Constructor which starts measuring from now
+ */
+IdleMeter::IdleMeter()
+    : last_cycles(0), idle_cycles(0), window_start_us(0)
+{
+}
+
+/** @brief      Counts the time since the last call as idle if it was short
+ *  @details    A gap of more than a few hundred cycles means the idle task
+ *              was interrupted by another task, so that gap isn't counted.
+ */
+void IdleMeter::idle()
+{
+    uint32_t now = share_cycle_count();
+    uint32_t gap = now - last_cycles;
+    if (gap < IDLE_GAP_CYCLES)
+    {
+        idle_cycles += gap;
+    }
+    last_cycles = now;
+}
+
+/** @brief      Adds a known stretch of idle time
+ */
+void IdleMeter::add_idle(uint32_t cycles)
+{
+    idle_cycles += cycles;
+}
+
+/** @brief      Prints the idle share of the time since the last printout
+ *              and starts a new measurement
+ */
+void IdleMeter::print(Print& printer)
+{
+    uint32_t now_us = micros();
+    uint32_t window_us = now_us - window_start_us;
+    if (window_us == 0)
+    {
+        window_us = 1;
+    }
+    uint32_t cycles_per_us = SystemCoreClock / 1000000;
+    uint64_t idle_us = idle_cycles / (cycles_per_us > 0 ? cycles_per_us : 1);
+
+    printer.printf("Idle: %lu.%lu%% of %lu ms",
+                   (unsigned long)(idle_us * 100 / window_us),
+                   (unsigned long)(idle_us * 1000 / window_us % 10),
+                   (unsigned long)(window_us / 1000));
+    printer << endl;
+
+    idle_cycles = 0;
+    window_start_us = now_us;
+}
@@ -0,0 +1,187 @@
+/** @file   deadline_monitor.h
+ *  @brief  This file contains a monitor which checks that periodic tasks run
+ *          on time and that the drive train is getting fresh drive states.
+ *  @details Each periodic task owns a @c Deadline and checks in with it once
+ *           per period. The deadline counts the periods which were missed and
+ *           keeps the worst lateness. The drive train uses a @c FreshnessGuard
+ *           to slow down, and then stop, if no new drive command has been
+ *           published for too long. Like shares, deadlines put themselves into a list so
+ *           the diagnostics task can print all of them.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ *  @date    18 Oct 2026 Early check ins recorded so jitter can be compared
+ *                       between builds; added the idle time meter
+ *  @date    18 Oct 2026 Freshness judged by the drive command's sequence
+ *                       number rather than by the IR array task's check ins
+ */
+
+
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+#include <Arduino.h>
+#include "baseshare.h"
+
+/** @brief   Class which watches one periodic task for missed deadlines.
+ *  @details Times are measured with @c micros(). A period counts as missed
+ *           when the time between two check ins is more than the period plus
+ *           one RTOS tick of allowed jitter. Only the owning task writes to a
+ *           deadline; other tasks just read its 32 bit fields, which the
+ *           processor reads in one go.
+ */
+class Deadline
+{
+private:
+
+const char* name;                   ///< Name shown in diagnostic printouts
+uint32_t period_us;                 ///< How often the task should check in
+uint32_t slack_us;                  ///< Lateness allowed before a miss counts
+uint32_t last_check_in_us;          ///< Time of the most recent check in
+uint32_t check_ins;                 ///< Number of times the task checked in
+uint32_t missed;                    ///< Number of missed periods
+uint32_t max_late_us;               ///< Worst lateness seen
+uint32_t max_early_us;              ///< Most a check in came before its time
+Deadline* p_next;                   ///< Next deadline in the list
+
+/// The most recently created deadline, the head of the list
+static Deadline* p_newest;
+
+public:
+
+/** @brief      Constructor which sets up the deadline for one task
+ *
+ *  @param      p_name      Name of the task, shown in diagnostic printouts
+ *  @param      period_ms   Period of the task in milliseconds
+ */
+Deadline(const char* p_name, uint32_t period_ms);
+
+/** @brief      Called by the task once every period
+ */
+void check_in();
+
+/** @brief      Returns the microseconds since the task last checked in
+ *  @details    Before the first check in, a very large age is returned so
+ *              that anything waiting on the task treats it as stale.
+ */
+uint32_t age_us() const;
+
+/** @brief      Prints this deadline's statistics on one line
+ */
+void print_in_list(Print& printer);
+
+// Prints every deadline in the system
+friend void print_all_deadlines(Print& printer);
+
+}; //end class Deadline
+
+
+/// The ways in which the drive train can run, from best to worst
+enum DriveMode : uint8_t
+{
+    DRIVE_NORMAL = 0,               ///< Fresh data; drive at full speed
+    DRIVE_REDUCED = 1,              ///< Data is late; drive slowly
+    DRIVE_STOPPED = 2               ///< Data is stale; don't move
+};
+
+/** @brief   Class which degrades the drive train when its data goes stale.
+ *  @details The guard is given the sequence number of each message the
+ *           drive train reads and times how long it has been since the
+ *           number last changed. The age is that of the data itself, so a
+ *           task which keeps running but stops publishing, or a topic
+ *           which keeps handing out the same message, is caught as well as
+ *           a task which has stalled. Past the first limit the speeds are
+ *           halved; past the second the motors are stopped. The drive train
+ *           goes back to normal as soon as a new message arrives.
+ */
+class FreshnessGuard
+{
+private:
+
+uint32_t reduce_after_us;           ///< Age at which speeds are halved
+uint32_t stop_after_us;             ///< Age at which the motors stop
+uint32_t last_sequence;             ///< Sequence number of the newest data
+uint32_t last_fresh_us;             ///< Time the newest data arrived
+DriveMode mode;                     ///< Mode chosen by the last update()
+uint32_t reduced_count;             ///< Times the drive train was slowed
+uint32_t stopped_count;             ///< Times the drive train was stopped
+
+public:
+
+/** @brief      Constructor which sets the freshness limits
+ *
+ *  @param      reduce_after_ms Age of the data at which to slow down
+ *  @param      stop_after_ms   Age of the data at which to stop
+ */
+FreshnessGuard(uint32_t reduce_after_ms, uint32_t stop_after_ms);
+
+/** @brief      Checks the age of the data and chooses the drive mode
+ *
+ *  @param      sequence    Sequence number of the message just read, from
+ *                          @c Subscriber::get_sequence(); zero if nothing
+ *                          has been published yet
+ *  @return     The mode in which the drive train may run
+ */
+DriveMode update(uint32_t sequence);
+
+/** @brief      Changes wheel speeds to suit the current drive mode
+ *
+ *  @param      left    Speed for the left wheel, changed in place
+ *  @param      right   Speed for the right wheel, changed in place
+ */
+void limit(int16_t& left, int16_t& right) const;
+
+/** @brief      Prints the current mode and how often it has degraded
+ */
+void print(Print& printer) const;
+
+}; //end class FreshnessGuard
+
+
+// Prints a table of every deadline in the system
+void print_all_deadlines(Print& printer);
+
+
+/** @brief   Class which measures how much of the processor's time is spare.
+ *  @details Under FreeRTOS, @c idle() is called over and over from the idle
+ *           task. The time between two calls counts as idle unless it is
+ *           long enough that another task must have run in between. The
+ *           cyclic executive knows exactly how long it waited for each frame
+ *           and gives that to @c add_idle(). Times are measured in processor
+ *           cycles and the result is the share of the time since the last
+ *           printout, so both builds are measured the same way.
+ */
+class IdleMeter
+{
+private:
+
+uint32_t last_cycles;               ///< Cycle count at the last idle() call
+uint64_t idle_cycles;               ///< Idle cycles since the last printout
+uint32_t window_start_us;           ///< Time of the last printout
+
+public:
+
+/** @brief      Constructor which starts measuring from now
+ */
+IdleMeter();
+
+/** @brief      Counts the time since the last call as idle if it was short
+ */
+void idle();
+
+/** @brief      Adds a known stretch of idle time
+ *  @param      cycles  Processor cycles spent idle
+ */
+void add_idle(uint32_t cycles);
+
+/** @brief      Prints the idle share of the time since the last printout
+ *              and starts a new measurement
+ */
+void print(Print& printer);
+
+}; //end class IdleMeter
+
+#endif //end if: define deadline monitor declarations
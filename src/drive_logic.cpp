@@ -0,0 +1,203 @@
+/** @file   drive_logic.cpp
+ *  @brief  This file contains the definitions of the decision logic used by
+ *          the vision and drive train tasks.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created, logic moved out of main.cpp
+ *  @date   18 Oct 2026     Wheel speeds and motor filter made tunable
+ *  @date   18 Oct 2026     Line tracker for intersections, corners and
+ *                          recovering a lost line
+ */
+
+#include "drive_logic.h"
+
+/** @brief      Turns an IR frame into one of the 5 drive states
+ *  @details    Sensor 8 is on bot's driver side, sensor 1 is on bot's
+ *              passenger side.
+ *
+ *  @param      frame       Bitmask of the sensors which see the line
+ *  @param      last_state  Drive state chosen for the previous frame
+ *  @return     The drive state for this frame
+ */
+uint8_t classify_frame(uint8_t frame, uint8_t last_state)
+{
+    switch (frame)
+    {
+        //drive state 0: drive straight when only the middle sensors 4 and 5 see the line
+        case 0b00011000:
+            return 0;
+
+        //drive state 1: rotate CCW when sensors 8-5 (driver side) see the line
+        //and sensors 4-1 (passengers side) do NOT see the line
+        case 0b11110000:
+            return 1;
+
+        //drive state 2: turn left when (sensors 5 and 6) OR (sensors 6 and 7)
+        //see the line and all other sensors do NOT see the line
+        case 0b01100000:
+        case 0b00110000:
+            return 2;
+
+        //drive state 3: turn right when (sensors 4 and 3) OR (sensors 3 and 2)
+        //see the line and all other sensors do NOT see the line
+        case 0b00001100:
+        case 0b00000110:
+            return 3;
+
+        //drive state 4: rotate CW when sensors 4-1 (passenger side) see the line
+        //and sensors 8-5 (drivers side) do NOT see the line
+        case 0b00001111:
+            return 4;
+
+        default:
+            return last_state;
+    }
+}
+
+/** @brief      Chooses the drive state for a line from its position
+ *  @details    The center is in half sensors from the middle of the array,
+ *              positive toward the driver side. A line a sensor or more off
+ *              the middle is turned toward.
+ */
+static uint8_t steer_toward(int8_t center)
+{
+    if (center >= 2)
+    {
+        return 2;       // turn left
+    }
+    if (center <= -2)
+    {
+        return 3;       // turn right
+    }
+    return 0;
+}
+
+/** @brief      Chooses the drive state for a frame from its features
+ *
+ *  @param      tracker     State kept from the previous frame, updated
+ *  @param      frame       Bitmask of the sensors which see the line
+ *  @param      features    Features of @c frame from extract_line_features()
+ *  @return     The drive state for this frame, or 0xFF if there is none yet
+ */
+uint8_t track_line(LineTracker& tracker, uint8_t frame,
+                   const LineFeatures& features)
+{
+    uint8_t state = classify_frame(frame, 0xFF);
+    if (state == 0xFF)
+    {
+        switch (features.kind)
+        {
+            case LINE_NONE:
+                // recover toward where the line was last seen; a line which
+                // ended in an intersection was a T, so take the left branch
+                if (tracker.last_kind == LINE_CROSSING)
+                {
+                    state = 2;
+                }
+                else if (tracker.last_kind != LINE_NONE
+                         && steer_toward(tracker.last_center) != 0)
+                {
+                    state = steer_toward(tracker.last_center);
+                }
+                else
+                {
+                    state = tracker.drive_state;
+                }
+                break;
+
+            case LINE_CROSSING:
+                state = 0;
+                break;
+
+            case LINE_CORNER_LEFT:
+                state = 1;
+                break;
+
+            case LINE_CORNER_RIGHT:
+                state = 4;
+                break;
+
+            case LINE_SINGLE:
+            case LINE_WIDE:
+                state = steer_toward(features.center);
+                break;
+
+            default:
+                state = tracker.drive_state;
+                break;
+        }
+    }
+
+    if (features.kind != LINE_NONE)
+    {
+        tracker.last_kind = features.kind;
+        tracker.last_center = features.center;
+    }
+    tracker.drive_state = state;
+    return state;
+}
+
+/** @brief      Chooses the speed of both wheels for a drive state
+ *
+ *  @param      drive_state State chosen by classify_frame()
+ *  @param      params      Speeds to use for each kind of motion
+ *  @param      left        Set to the speed for the left wheel
+ *  @param      right       Set to the speed for the right wheel
+ *  @return     True if @c drive_state is known and the speeds were set
+ */
+bool drive_speeds(uint8_t drive_state, const DriveParams& params,
+                  int16_t& left, int16_t& right)
+{
+    const int16_t cruise = (int16_t)params.max_speed * params.cruise_percent / 100;
+    const int16_t turn = (int16_t)params.max_speed * params.turn_percent / 100;
+    const int16_t spin = (int16_t)params.max_speed * params.spin_percent / 100;
+
+    switch (drive_state)
+    {
+        case 0:     // go straight
+            left = cruise;
+            right = cruise;
+            return true;
+
+        case 1:     // rotate counter clockwise
+            left = spin;
+            right = -spin;
+            return true;
+
+        case 2:     // turn left, right wheel spins faster than left
+            left = turn;
+            right = cruise;
+            return true;
+
+        case 3:     // turn right, left wheel spins faster than right
+            left = cruise;
+            right = turn;
+            return true;
+
+        case 4:     // rotate clockwise
+            left = -spin;
+            right = spin;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/** @brief      Runs one step of the first-order filter which smooths changes
+ *              in motor power
+ *
+ *  @param      speed       Filtered speed from the previous step
+ *  @param      target      Speed the drive train is asking for
+ *  @param      sim_A       Time constant, from 0 (no filtering) to just
+ *                          under 1 (very slow changes)
+ *  @return     The filtered speed for this step
+ */
+float filter_speed(float speed, int16_t target, float sim_A)
+{
+    float magnitude = target < 0 ? -target : target;
+    return speed * sim_A + magnitude * (1.0f - sim_A);
+}
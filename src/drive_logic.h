@@ -0,0 +1,116 @@
+/** @file   drive_logic.h
+ *  @brief  This file contains the decision logic used by the vision and
+ *          drive train tasks. It has no hardware dependencies so the same
+ *          code runs on the nucleo and in the host tools that replay
+ *          recorded sensor traces.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created, logic moved out of main.cpp
+ *  @date    18 Oct 2026 Wheel speeds and motor filter made tunable
+ *  @date    18 Oct 2026 Line tracker which uses the line's features for
+ *                       frames which match none of the patterns
+ */
+
+
+#ifndef DRIVE_LOGIC_H
+#define DRIVE_LOGIC_H
+
+#include <stdint.h>
+#include "line_features.h"
+
+/** @brief   Tunable settings which turn a drive state into wheel speeds.
+ *  @details The percentages are of @c max_speed. The defaults are the speeds
+ *           the CleanBot was first tuned with: half speed going straight and
+ *           spinning, and a quarter speed inner wheel when turning.
+ */
+struct DriveParams
+{
+    uint8_t max_speed = 255;        ///< Speed of a wheel at full power
+    uint8_t cruise_percent = 50;    ///< Both wheels when driving straight
+    uint8_t turn_percent = 25;      ///< Inner wheel in a turn; outer cruises
+    uint8_t spin_percent = 50;      ///< Both wheels when rotating in place
+};
+
+/// Default time constant of the motor speed filter, see filter_speed()
+const float DEFAULT_SIM_A = 0.99;
+
+/** @brief      Turns an IR frame into one of the 5 drive states
+ *  @details    The frame is the bitmask from IR_Array::getFrame(), with
+ *              sensor 1 in bit 0 and sensor 8 in bit 7. The drive states are:
+ *              0: drive in straight line
+ *              1: rotate CCW
+ *              2: turn left
+ *              3: turn right
+ *              4: rotate CW
+ *              A frame which matches none of the patterns leaves the drive
+ *              state unchanged.
+ *
+ *  @param      frame       Bitmask of the sensors which see the line
+ *  @param      last_state  Drive state chosen for the previous frame
+ *  @return     The drive state for this frame
+ */
+uint8_t classify_frame(uint8_t frame, uint8_t last_state);
+
+/** @brief   What the line tracker remembers from one frame to the next.
+ */
+struct LineTracker
+{
+    uint8_t drive_state = 0xFF;     ///< Drive state chosen for the last frame
+    LineKind last_kind = LINE_NONE; ///< Kind of the last frame with a line
+    int8_t last_center = 0;         ///< Center of the last frame with a line
+};
+
+/** @brief      Chooses the drive state for a frame from its features
+ *  @details    Frames which match one of the patterns in classify_frame()
+ *              get the same drive state as before. Other frames are handled
+ *              by the shape of the line:
+ *              - A T or cross intersection is driven straight through.
+ *              - A sharp corner rotates the CleanBot toward it, as the
+ *                0b11110000 and 0b00001111 patterns do.
+ *              - A single or wide piece of line is steered toward: straight
+ *                if its center is within half a sensor of the middle, and
+ *                a turn toward it if it's further off to one side.
+ *              - With two pieces of line, such as a fork, the drive state is
+ *                kept.
+ *              When the line is lost, the CleanBot recovers by turning
+ *              toward the side it was last seen on. If the last thing seen
+ *              was an intersection, the line ended in a T, so it turns
+ *              toward the driver side to follow the left branch.
+ *
+ *  @param      tracker     State kept from the previous frame, updated
+ *  @param      frame       Bitmask of the sensors which see the line
+ *  @param      features    Features of @c frame from extract_line_features()
+ *  @return     The drive state for this frame, or 0xFF if there is none yet
+ */
+uint8_t track_line(LineTracker& tracker, uint8_t frame,
+                   const LineFeatures& features);
+
+/** @brief      Chooses the speed of both wheels for a drive state
+ *  @details    Speeds are signed; a negative value drives the wheel backward.
+ *
+ *  @param      drive_state State chosen by classify_frame()
+ *  @param      params      Speeds to use for each kind of motion
+ *  @param      left        Set to the speed for the left wheel
+ *  @param      right       Set to the speed for the right wheel
+ *  @return     True if @c drive_state is known and the speeds were set
+ */
+bool drive_speeds(uint8_t drive_state, const DriveParams& params,
+                  int16_t& left, int16_t& right);
+
+/** @brief      Runs one step of the first-order filter which smooths changes
+ *              in motor power
+ *  @details    The filter only acts on the size of the speed; the direction
+ *              is set straight away by the motor driver.
+ *
+ *  @param      speed       Filtered speed from the previous step
+ *  @param      target      Speed the drive train is asking for
+ *  @param      sim_A       Time constant, from 0 (no filtering) to just
+ *                          under 1 (very slow changes)
+ *  @return     The filtered speed for this step
+ */
+float filter_speed(float speed, int16_t target, float sim_A);
+
+#endif //end if: define drive logic declarations
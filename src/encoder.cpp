@@ -0,0 +1,63 @@
+/** @file encoder.cpp
+ *    This file contains the implementation of a quadrature encoder counter
+ *    which uses one external interrupt per encoder.
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *  @date 18 Oct 2026
+ */
+
+
+#include <Arduino.h>
+#include "encoder.h"
+
+
+/** @brief   Constructor which starts the count at zero.
+ */
+Encoder::Encoder()
+    : PIN_A(0), PIN_B(0), reversed(false), count(0)
+{
+}
+
+/** @brief   Function which sets up the encoder's pins and interrupt.
+ *  @details Channel A interrupts on both edges, which gives half of the
+ *           encoder's full quadrature resolution.
+ */
+void Encoder::SetPins(uint8_t A_PIN, uint8_t B_PIN, bool REVERSED)
+{
+    PIN_A = A_PIN;
+    PIN_B = B_PIN;
+    reversed = REVERSED;
+
+    pinMode(PIN_A, INPUT_PULLUP);
+    pinMode(PIN_B, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(PIN_A), [this] () { Edge(); },
+                    CHANGE);
+}
+
+/** @brief   Function which counts one edge of channel A.
+ *  @details Turning forward, channel A leads channel B, so just after an
+ *           edge of A the two channels differ. This runs in the interrupt,
+ *           which is the only writer of the count.
+ */
+void Encoder::Edge()
+{
+    bool forward = digitalRead(PIN_A) != digitalRead(PIN_B);
+    if (forward != reversed)
+    {
+        count = count + 1;
+    }
+    else
+    {
+        count = count - 1;
+    }
+}
+
+/** @brief   Function which sets the count back to zero.
+ */
+void Encoder::Clear()
+{
+    noInterrupts();
+    count = 0;
+    interrupts();
+}
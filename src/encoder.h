@@ -0,0 +1,74 @@
+/** @file   encoder.h
+ *  @brief  This file contains a class which counts the pulses from one of
+ *          the magnetic encoders on the back of the drive motors.
+ *  @details The encoders are two channel quadrature encoders. Channel A
+ *           interrupts on every edge and the level of channel B at that
+ *           moment gives the direction, so each encoder only needs one of
+ *           the STM32's external interrupt lines, and the four encoder pins
+ *           fit on A0 to A3 without two channel A pins sharing an EXTI line.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ */
+
+
+#ifndef ENCODER_H
+#define ENCODER_H
+
+#include <Arduino.h>
+
+/// Encoder counts per turn of a wheel: 6 edges of channel A per motor turn
+/// through a 75:1 gearbox
+const uint16_t ENCODER_COUNTS_PER_REV = 450;
+
+/// Diameter of the drive wheels in millimeters
+const float WHEEL_DIAMETER_MM = 42.0f;
+
+/** @brief   Class which counts the pulses from one quadrature encoder
+ *  @details The count is kept by an interrupt, so it is always up to date;
+ *           the encoder task only has to read it.
+ */
+class Encoder
+{
+private:
+
+// 8 bit integers to hold which pins of the nucleo the encoder is attatched to
+uint8_t PIN_A;
+uint8_t PIN_B;
+
+bool reversed;                      ///< True if forward counts down
+volatile int32_t count;             ///< Counts since the encoder was cleared
+
+// Counts one edge of channel A
+void Edge();
+
+public:
+
+/** @brief      Constructor which starts the count at zero
+ */
+Encoder();
+
+/** @brief      Sets the encoder's pins and starts counting
+ *
+ *  @param      A_PIN       pin for channel A, which must have an EXTI line
+ *                          of its own
+ *  @param      B_PIN       pin for channel B
+ *  @param      REVERSED    true for an encoder which counts down when its
+ *                          wheel drives forward, as on a mirrored motor
+ */
+void SetPins(uint8_t A_PIN, uint8_t B_PIN, bool REVERSED = false);
+
+/** @brief      Returns the count, which goes up as the wheel drives forward
+ */
+int32_t GetCount() const { return count; }
+
+/** @brief      Sets the count back to zero
+ */
+void Clear();
+
+}; //end class decleration
+
+#endif //end if: define encoder class declaration
@@ -0,0 +1,401 @@
+/** @file arena.cpp
+ *      This file contains a PC program which measures how much floor a
+ *      fleet of CleanBots disinfects. Several stadium tracks are taped on
+ *      one floor with two simulated CleanBots on each, half a lap apart.
+ *      Every robot runs its own copy of the firmware's line tracker, route
+ *      map, odometry and coverage grid, with the track model standing in
+ *      for its IR array and the motor model for its motor drivers. All of
+ *      the robots' lamps expose one shared coverage grid of the whole
+ *      floor.
+ *
+ *      The robots are stepped in chunks of simulated time, one job per
+ *      robot per chunk, on a work stealing pool. The program first runs a
+ *      short session on 1, 2, 4 and so on up to the chosen number of
+ *      threads and prints how many robot steps per second each managed;
+ *      since the shared grid comes out the same whatever the order of the
+ *      exposures, the cells done by each must match. It then runs the fleet
+ *      for the chosen number of simulated hours and prints the fleet's
+ *      coverage of the whole floor every 10 simulated minutes and the area
+ *      done in each hour. Robots on fixed tracks only ever pass over the
+ *      floor along their own tape, so nearly all of that area is done in
+ *      the first hour. Build it with <tt>pio run -e arena</tt>.
+ *
+ *      Usage: <tt>arena [--robots N] [--hours N] [--threads N]
+ *             [--scale-minutes N] [--dose counts]</tt>
+ *
+ *  @author  WC Montgomery, A Recidoro, A Haduong
+ *
+ *  @date    18 Oct 2026    Original file
+ *  @date    18 Oct 2026    Coverage is the share of the whole floor done
+ *  @date    18 Oct 2026    Steps per second count only the steps taken
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "drive_logic.h"
+#include "coverage_grid.h"
+#include "route_map.h"
+#include "host/common/work_pool.h"
+#include "host/sim/track_sim.h"
+#include "host/arena/floor_map.h"
+#include "host/arena/fleet_coverage.h"
+
+/// Simulated milliseconds each robot is stepped by one job
+static const uint32_t CHUNK_MS = 10000;
+
+/// Simulated milliseconds between lines of the coverage report
+static const uint32_t REPORT_MS = 600000;
+
+/// Milliseconds between exposures of the shared grid, as in the LED task
+static const uint32_t LAMP_PERIOD_MS = COVERAGE_DOSE_MS;
+
+/// Distance from the tape at which the line counts as lost, in meters
+static const float LOST_LIMIT = 0.15f;
+
+/// Tracks across the floor, and the space given to each
+static const uint8_t TRACK_COLUMNS = 3;
+static const float TRACK_PITCH_X = 3.2f;
+static const float TRACK_PITCH_Y = 1.4f;
+
+/// Rows of tracks which fit on the floor
+static const uint8_t TRACK_ROWS = 6;
+
+/// Tiles of the shared grid across and down the floor, 9.6 m square
+static const uint8_t FLOOR_TILES = 3;
+
+/// Cells in the shared grid, which covers the whole floor
+static const uint32_t FLOOR_CELLS = (uint32_t)FLOOR_TILES * FLOOR_TILES
+                                    * COVERAGE_COLUMNS * COVERAGE_ROWS;
+
+/// Length of each straight and radius of each half circle, in meters
+static const float TRACK_STRAIGHT = 1.5f;
+static const float TRACK_RADIUS = 0.5f;
+
+
+/** @brief   One simulated CleanBot with its own copy of the firmware's state.
+ *  @details The route map and coverage grid are the robot's own, kept in
+ *           its odometry's coordinates as on the real robot. The robot is
+ *           never moved once made, since the model keeps pointers to them.
+ */
+struct ArenaRobot
+{
+    size_t track;                   ///< Floor track the robot drives on
+    SimRobot robot;                 ///< Line tracker, motors and odometry
+    RouteMap route;                 ///< The robot's own route map
+    CoverageGrid grid;              ///< The robot's own coverage grid
+    bool lost;                      ///< True once it has run off the line
+
+    /** @brief   Constructor which places a robot on a track.
+     *  @param   params      Speeds and filter settings
+     *  @param   floor       Floor the robot drives on
+     *  @param   index       Track to place it on
+     *  @param   progress    Distance along the track to start at, in meters
+     *  @param   coverage    Lamp settings for the robot's own grid
+     */
+    ArenaRobot (const RobotParams& params, const FloorMap& floor,
+                size_t index, float progress, const CoverageParams& coverage)
+        : track (index), robot (params, 0.0f, 0.0f, 0.0f), route (),
+          grid (coverage), lost (false)
+    {
+        float x, y, heading;
+        floor.get_track (index).track.pose_at (progress, x, y, heading);
+        x -= SimRobot::SENSOR_OFFSET * cosf (heading);
+        y -= SimRobot::SENSOR_OFFSET * sinf (heading);
+        robot = SimRobot (params, x, y, heading);
+
+        const FloorMap* p_floor = &floor;
+        robot.set_frame_source ([p_floor, index] (const SimRobot& model,
+                                                  const Track&)
+        {
+            return p_floor->read_frame (model, index);
+        });
+        robot.set_route_map (&route);
+        robot.set_coverage_grid (&grid, true);
+    }
+};
+
+/// Every robot of a fleet; each is made once and never moved
+typedef std::vector<std::unique_ptr<ArenaRobot>> Fleet;
+
+/** @brief   Lays out the tracks and places two robots on each.
+ */
+static Fleet make_fleet (const FloorMap& floor, const RobotParams& params,
+                         const CoverageParams& coverage, uint32_t robots)
+{
+    Fleet fleet;
+    for (uint32_t number = 0; number < robots; number++)
+    {
+        size_t index = number / 2;
+        float progress = (number % 2) * 0.5f
+                         * floor.get_track (index).track.length ();
+        fleet.emplace_back (new ArenaRobot (params, floor, index, progress,
+                                            coverage));
+    }
+    return fleet;
+}
+
+/** @brief   Steps one robot through a stretch of simulated time.
+ *  @details Every lamp period the robot's true position on the floor
+ *           exposes the shared grid; its own grid is exposed by the model
+ *           from its odometry.
+ */
+static void run_robot (ArenaRobot& entry, const FloorMap& floor,
+                       FleetCoverage& shared, uint32_t end_ms)
+{
+    const FloorTrack& home = floor.get_track (entry.track);
+    SimRobot& robot = entry.robot;
+    while (!entry.lost && robot.get_time_ms () < end_ms)
+    {
+        robot.step (home.track);
+        if (robot.get_time_ms () % LAMP_PERIOD_MS != 0)
+        {
+            continue;
+        }
+
+        float sx, sy, progress;
+        robot.sensor_center (sx, sy);
+        if (home.track.nearest (sx, sy, progress) > LOST_LIMIT)
+        {
+            entry.lost = true;
+            break;
+        }
+        shared.expose ((home.x + robot.get_x ()) * 1000.0f,
+                       (home.y + robot.get_y ()) * 1000.0f,
+                       robot.get_heading ());
+    }
+}
+
+/** @brief   Steps the whole fleet up to a time, one job per robot.
+ */
+static void run_fleet (WorkPool& pool, Fleet& fleet, const FloorMap& floor,
+                       FleetCoverage& shared, uint32_t end_ms)
+{
+    std::vector<WorkPool::Job> jobs;
+    for (std::unique_ptr<ArenaRobot>& p_entry : fleet)
+    {
+        ArenaRobot* p_robot = p_entry.get ();
+        jobs.push_back ([p_robot, &floor, &shared, end_ms] (size_t)
+        {
+            run_robot (*p_robot, floor, shared, end_ms);
+        });
+    }
+    pool.run (jobs);
+}
+
+/** @brief   Counts the robots which have run off the line.
+ */
+static uint32_t count_lost (const Fleet& fleet)
+{
+    uint32_t lost = 0;
+    for (const std::unique_ptr<ArenaRobot>& p_entry : fleet)
+    {
+        lost += p_entry->lost ? 1 : 0;
+    }
+    return lost;
+}
+
+/** @brief   Counts the steps the whole fleet has taken.
+ *  @details Each step is a simulated millisecond. A robot which has run off
+ *           the line stops being stepped, so its clock stops with it.
+ */
+static uint64_t count_steps (const Fleet& fleet)
+{
+    uint64_t steps = 0;
+    for (const std::unique_ptr<ArenaRobot>& p_entry : fleet)
+    {
+        steps += p_entry->robot.get_time_ms ();
+    }
+    return steps;
+}
+
+/** @brief   Runs a short session on more and more threads.
+ *  @details Each session starts from a new fleet and an empty shared grid.
+ */
+static void measure_scaling (const FloorMap& floor, const RobotParams& params,
+                             const CoverageParams& coverage,
+                             const CoverageParams& floor_coverage,
+                             uint32_t robots, size_t max_threads,
+                             uint32_t minutes)
+{
+    const uint32_t end_ms = minutes * 60000;
+    printf ("Scaling over %lu simulated minutes of %lu robots\n",
+            (unsigned long)minutes, (unsigned long)robots);
+    printf (" threads  wall_s  steps/s     speedup  cells_done\n");
+
+    double first_rate = 0.0;
+    uint32_t first_dosed = 0;
+    std::vector<size_t> counts;
+    for (size_t threads = 1; threads < max_threads; threads *= 2)
+    {
+        counts.push_back (threads);
+    }
+    counts.push_back (max_threads);
+
+    for (size_t threads : counts)
+    {
+        Fleet fleet = make_fleet (floor, params, coverage, robots);
+        FleetCoverage shared (floor_coverage, FLOOR_TILES, FLOOR_TILES);
+        WorkPool pool (threads);
+
+        auto begin = std::chrono::steady_clock::now ();
+        for (uint32_t time_ms = CHUNK_MS; time_ms <= end_ms;
+             time_ms += CHUNK_MS)
+        {
+            run_fleet (pool, fleet, floor, shared, time_ms);
+        }
+        double seconds = std::chrono::duration<double> (
+            std::chrono::steady_clock::now () - begin).count ();
+
+        double rate = (double)count_steps (fleet) / seconds;
+        if (first_rate == 0.0)
+        {
+            first_rate = rate;
+            first_dosed = shared.get_dosed ();
+        }
+        printf ("%8zu  %6.2f  %10.0f  %6.2fx  %10lu%s\n", threads, seconds,
+                rate, rate / first_rate, (unsigned long)shared.get_dosed (),
+                shared.get_dosed () == first_dosed ? "" : "  differs!");
+    }
+    printf ("\n");
+}
+
+
+/** @brief   Measures the scaling, then runs the fleet and reports coverage.
+ */
+int main (int argc, char** argv)
+{
+    uint32_t robots = 12;
+    uint32_t hours = 1;
+    uint32_t scale_minutes = 2;
+    size_t threads = std::thread::hardware_concurrency ();
+    RobotParams params;
+    params.drive.max_speed = 255;
+    params.drive.cruise_percent = 90;
+    params.drive.turn_percent = 15;
+    params.drive.spin_percent = 50;
+    params.sim_A = 0.5f;
+
+    // Each robot's own grid starts near its bottom left corner, as in
+    // uv_sim; the shared grid's corner is the floor's
+    CoverageParams coverage;
+    coverage.origin_x_mm = -800;
+    coverage.origin_y_mm = -800;
+
+    for (int arg = 1; arg + 1 < argc; arg += 2)
+    {
+        if (strcmp (argv[arg], "--robots") == 0)
+        {
+            robots = (uint32_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--hours") == 0)
+        {
+            hours = (uint32_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--threads") == 0)
+        {
+            threads = (size_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--scale-minutes") == 0)
+        {
+            scale_minutes = (uint32_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--dose") == 0)
+        {
+            coverage.required_dose = (uint8_t)atoi (argv[arg + 1]);
+        }
+        else
+        {
+            fprintf (stderr, "Unknown option %s\n", argv[arg]);
+            return 2;
+        }
+    }
+    if (threads == 0)
+    {
+        threads = 1;
+    }
+    const uint32_t most = 2 * TRACK_COLUMNS * TRACK_ROWS;
+    if (robots == 0 || robots > most)
+    {
+        fprintf (stderr, "From 1 to %lu robots fit on the floor\n",
+                 (unsigned long)most);
+        return 2;
+    }
+
+    FloorMap floor;
+    for (uint32_t index = 0; index < (robots + 1) / 2; index++)
+    {
+        floor.add_track (TRACK_STRAIGHT, TRACK_RADIUS,
+                         0.8f + TRACK_PITCH_X * (index % TRACK_COLUMNS),
+                         0.8f + TRACK_PITCH_Y * (index / TRACK_COLUMNS));
+    }
+    printf ("%lu robots on %zu tracks of %.2f m; dose %u counts\n\n",
+            (unsigned long)robots, floor.size (),
+            floor.get_track (0).track.length (), coverage.required_dose);
+
+    // The shared grid has its corner at the floor's
+    CoverageParams floor_coverage = coverage;
+    floor_coverage.origin_x_mm = 0;
+    floor_coverage.origin_y_mm = 0;
+
+    if (scale_minutes > 0)
+    {
+        measure_scaling (floor, params, coverage, floor_coverage, robots,
+                         threads, scale_minutes);
+    }
+    FleetCoverage shared (floor_coverage, FLOOR_TILES, FLOOR_TILES);
+    Fleet fleet = make_fleet (floor, params, coverage, robots);
+    WorkPool pool (threads);
+
+    printf ("Fleet coverage on %zu threads\n", pool.size ());
+    printf ("   minute  cells_seen  cells_done  area_m2  floor_done  lost\n");
+    const uint32_t end_ms = hours * 3600000;
+    uint32_t hour_start_cells = 0;
+    std::vector<float> hourly;
+    for (uint32_t time_ms = CHUNK_MS; time_ms <= end_ms; time_ms += CHUNK_MS)
+    {
+        run_fleet (pool, fleet, floor, shared, time_ms);
+
+        uint32_t dosed = shared.get_dosed ();
+        if (time_ms % REPORT_MS == 0)
+        {
+            printf ("   %6lu  %10lu  %10lu  %7.2f  %9.1f%%  %4lu\n",
+                    (unsigned long)(time_ms / 60000),
+                    (unsigned long)shared.get_touched (),
+                    (unsigned long)dosed,
+                    dosed * FleetCoverage::cell_area (),
+                    dosed * 100.0f / FLOOR_CELLS,
+                    (unsigned long)count_lost (fleet));
+        }
+        if (time_ms % 3600000 == 0)
+        {
+            hourly.push_back ((dosed - hour_start_cells)
+                              * FleetCoverage::cell_area ());
+            hour_start_cells = dosed;
+        }
+    }
+
+    printf ("\nArea done per simulated hour, of %.2f m2 of floor\n",
+            FLOOR_CELLS * FleetCoverage::cell_area ());
+    float total = 0.0f;
+    for (size_t hour = 0; hour < hourly.size (); hour++)
+    {
+        printf ("   hour %zu: %.2f m2\n", hour + 1, hourly[hour]);
+        total += hourly[hour];
+    }
+    printf ("\nThe robots follow fixed tracks, so they only dose the floor "
+            "along their own\ntape and reach their limit within the first "
+            "hour; more floor needs more\ntracks, not more time.\n");
+    if (hourly.size () > 1 && total > 0.0f)
+    {
+        printf ("The first hour did %.0f%% of the area done in %zu hours.\n",
+                hourly[0] * 100.0f / total, hourly.size ());
+    }
+    return 0;
+}
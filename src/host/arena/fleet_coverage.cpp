@@ -0,0 +1,136 @@
+/** @file   fleet_coverage.cpp
+ *  @brief  This file contains the definitions of the coverage grid which a
+ *          fleet of simulated CleanBots exposes from many threads.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ */
+
+#include <math.h>
+#include "host/arena/fleet_coverage.h"
+
+/// Length of each side of a tile, in millimeters
+static const float TILE_MM = (float)COVERAGE_COLUMNS * COVERAGE_CELL_MM;
+
+
+/** @brief      Constructor which makes a floor with no dose anywhere
+ */
+FleetCoverage::FleetCoverage(const CoverageParams& coverage_params,
+                             uint8_t across, uint8_t down)
+    : params(coverage_params), tiles_x(across), tiles_y(down)
+{
+    for (uint8_t row = 0; row < tiles_y; row++)
+    {
+        for (uint8_t column = 0; column < tiles_x; column++)
+        {
+            std::unique_ptr<Tile> p_tile(new Tile);
+            p_tile->params = params;
+            p_tile->params.origin_x_mm =
+                (int16_t)(params.origin_x_mm + column * TILE_MM);
+            p_tile->params.origin_y_mm =
+                (int16_t)(params.origin_y_mm + row * TILE_MM);
+            p_tile->touched.store(0);
+            p_tile->dosed.store(0);
+            for (std::atomic<uint8_t>& dose : p_tile->doses)
+            {
+                dose.store(0);
+            }
+            tiles.push_back(std::move(p_tile));
+        }
+    }
+}
+
+/** @brief      Adds the dose from one robot's lamp
+ *  @details    The tiles within reach of the lamp's farthest corner are
+ *              each given the lamp; @c lamp_cells() leaves out the cells
+ *              which aren't in that tile. Relaxed atomics are enough, since
+ *              nothing else is read on the strength of a dose.
+ */
+void FleetCoverage::expose(float x_mm, float y_mm, float heading,
+                           uint8_t periods)
+{
+    float reach = hypotf(0.5f * params.lamp_length_mm
+                         + fabsf((float)params.lamp_offset_mm),
+                         0.5f * params.lamp_width_mm);
+    int first_column = (int)floorf((x_mm - reach - params.origin_x_mm)
+                                   / TILE_MM);
+    int last_column = (int)floorf((x_mm + reach - params.origin_x_mm)
+                                  / TILE_MM);
+    int first_row = (int)floorf((y_mm - reach - params.origin_y_mm)
+                                / TILE_MM);
+    int last_row = (int)floorf((y_mm + reach - params.origin_y_mm)
+                               / TILE_MM);
+    if (first_column < 0) first_column = 0;
+    if (first_row < 0) first_row = 0;
+    if (last_column >= tiles_x) last_column = tiles_x - 1;
+    if (last_row >= tiles_y) last_row = tiles_y - 1;
+
+    const uint8_t required = params.required_dose;
+    for (int row = first_row; row <= last_row; row++)
+    {
+        for (int column = first_column; column <= last_column; column++)
+        {
+            Tile& tile = *tiles[row * tiles_x + column];
+            uint16_t cells[COVERAGE_MAX_LAMP_CELLS];
+            uint8_t count = lamp_cells(tile.params, x_mm, y_mm, heading,
+                                       0.0f, cells);
+            for (uint8_t index = 0; index < count; index++)
+            {
+                std::atomic<uint8_t>& cell = tile.doses[cells[index]];
+                uint8_t before = cell.load(std::memory_order_relaxed);
+                uint8_t after = before;
+                do
+                {
+                    if (before == 255)
+                    {
+                        break;
+                    }
+                    after = periods < 255 - before ? before + periods : 255;
+                }
+                while (!cell.compare_exchange_weak(before, after,
+                                                   std::memory_order_relaxed));
+                if (before == 255)
+                {
+                    continue;
+                }
+
+                // Only the thread which made the change counts it
+                if (before == 0)
+                {
+                    tile.touched.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (before < required && after >= required)
+                {
+                    tile.dosed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+}
+
+/** @brief      Returns the number of cells which have had any dose
+ */
+uint32_t FleetCoverage::get_touched() const
+{
+    uint32_t total = 0;
+    for (const std::unique_ptr<Tile>& p_tile : tiles)
+    {
+        total += p_tile->touched.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/** @brief      Returns the number of cells which have had the required dose
+ */
+uint32_t FleetCoverage::get_dosed() const
+{
+    uint32_t total = 0;
+    for (const std::unique_ptr<Tile>& p_tile : tiles)
+    {
+        total += p_tile->dosed.load(std::memory_order_relaxed);
+    }
+    return total;
+}
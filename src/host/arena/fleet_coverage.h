@@ -0,0 +1,98 @@
+/** @file   fleet_coverage.h
+ *  @brief  This file contains a coverage grid which a whole fleet of
+ *          simulated CleanBots exposes at once, from many threads.
+ *  @details The floor is cut into tiles, each the size of the firmware's
+ *           @c CoverageGrid, and each tile has its own origin so the
+ *           firmware's @c lamp_cells() finds the cells under a lamp in it.
+ *           A lamp near the edge of a tile is looked up in each tile it
+ *           might reach.
+ *
+ *           No locks are taken. Each cell's dose is an atomic byte which is
+ *           raised with a compare and swap that stops at 255, so two robots
+ *           over the same cell at once both get their dose counted. The
+ *           thread whose swap takes a cell past zero, or up to the required
+ *           dose, adds one to that tile's count of cells touched or done;
+ *           the counts are kept per tile, each on its own cache line, so
+ *           robots in different parts of the floor never write to the same
+ *           line. Adding to a dose gives the same result in any order, so
+ *           the grid ends up the same however the robots are spread over
+ *           threads.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ */
+
+
+#ifndef FLEET_COVERAGE_H
+#define FLEET_COVERAGE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "coverage_grid.h"
+
+/** @brief   Class which keeps the UV dose of a large floor for many robots.
+ */
+class FleetCoverage
+{
+private:
+
+/** @brief   One tile of the floor, the size of a @c CoverageGrid.
+ */
+struct Tile
+{
+    CoverageParams params;          ///< Lamp settings and this tile's origin
+    alignas(64) std::atomic<uint32_t> touched;  ///< Cells with any dose
+    std::atomic<uint32_t> dosed;    ///< Cells with the required dose
+    alignas(64) std::atomic<uint8_t> doses[COVERAGE_ROWS * COVERAGE_COLUMNS];
+};
+
+CoverageParams params;              ///< Lamp settings and the floor's origin
+uint8_t tiles_x;                    ///< Tiles across the floor's x axis
+uint8_t tiles_y;                    ///< Tiles across the floor's y axis
+std::vector<std::unique_ptr<Tile>> tiles;   ///< Row by row
+
+public:
+
+/** @brief      Constructor which makes a floor with no dose anywhere
+ *
+ *  @param      coverage_params Lamp settings; the origin is the floor's
+ *                              corner, in floor millimeters
+ *  @param      across          Tiles along the x axis
+ *  @param      down            Tiles along the y axis
+ */
+FleetCoverage(const CoverageParams& coverage_params, uint8_t across,
+              uint8_t down);
+
+/** @brief      Adds the dose from one robot's lamp
+ *  @details    Safe to call from any number of threads at once.
+ *
+ *  @param      x_mm        Floor position of the middle of the axle
+ *  @param      y_mm        Floor position of the middle of the axle
+ *  @param      heading     Direction of travel in radians
+ *  @param      periods     Number of dose periods the lamp was on
+ */
+void expose(float x_mm, float y_mm, float heading, uint8_t periods = 1);
+
+/** @brief      Returns the number of cells which have had any dose
+ */
+uint32_t get_touched() const;
+
+/** @brief      Returns the number of cells which have had the required dose
+ */
+uint32_t get_dosed() const;
+
+/** @brief      Returns the area of one cell in square meters
+ */
+static float cell_area()
+{
+    return (COVERAGE_CELL_MM / 1000.0f) * (COVERAGE_CELL_MM / 1000.0f);
+}
+
+}; //end class FleetCoverage
+
+#endif //end if: define fleet coverage declarations
@@ -0,0 +1,75 @@
+/** @file   floor_map.cpp
+ *  @brief  This file contains the definitions of the PC model of a floor
+ *          with several taped tracks on it.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ */
+
+#include <math.h>
+#include "host/arena/floor_map.h"
+
+/// How far outside a track's tape a point can be and still need checking
+static const float TAPE_MARGIN = 0.05f;
+
+
+/** @brief      Puts a track on the floor
+ */
+size_t FloorMap::add_track(float straight, float radius, float x, float y)
+{
+    tracks.push_back({Track(straight, radius), x, y, straight, radius});
+    return tracks.size() - 1;
+}
+
+/** @brief      Returns true if a point of the floor is on any track's tape
+ *  @details    Each track is only asked if the point is inside the box
+ *              around it, which rules out nearly all of them.
+ */
+bool FloorMap::on_tape(float x, float y) const
+{
+    for (const FloorTrack& floor_track : tracks)
+    {
+        float local_x = x - floor_track.x;
+        float local_y = y - floor_track.y;
+        float reach = floor_track.radius + TAPE_MARGIN;
+        if (local_x < -reach || local_x > floor_track.straight + reach
+            || local_y < -reach || local_y > reach)
+        {
+            continue;
+        }
+        if (floor_track.track.on_tape(local_x, local_y))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief      Reads the IR array of a robot on one of the tracks
+ */
+uint8_t FloorMap::read_frame(const SimRobot& robot, size_t index) const
+{
+    const FloorTrack& home = tracks[index];
+    float sx, sy;
+    robot.sensor_center(sx, sy);
+    sx += home.x;
+    sy += home.y;
+
+    // Unit vector pointing to the robot's left
+    float left_x = -sinf(robot.get_heading());
+    float left_y = cosf(robot.get_heading());
+
+    uint8_t frame = 0;
+    for (uint8_t sensor = 0; sensor < 8; sensor++)
+    {
+        float offset = ((float)sensor - 3.5f) * SimRobot::SENSOR_PITCH;
+        if (on_tape(sx + offset * left_x, sy + offset * left_y))
+        {
+            frame |= 1 << sensor;
+        }
+    }
+    return frame;
+}
@@ -0,0 +1,84 @@
+/** @file   floor_map.h
+ *  @brief  This file contains a PC model of a floor with several taped
+ *          tracks on it, which a fleet of simulated CleanBots drives on.
+ *  @details Each track is a stadium shaped @c Track placed somewhere on the
+ *           floor. A robot's position is kept relative to the track it
+ *           started on, as in the single robot tools, and the floor map
+ *           turns that into floor coordinates. The IR frames come from every
+ *           track on the floor, so a robot which strays near another track
+ *           sees its tape. The map is never changed once the robots are
+ *           placed, so every thread reads it without locking.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ */
+
+
+#ifndef FLOOR_MAP_H
+#define FLOOR_MAP_H
+
+#include <stdint.h>
+#include <vector>
+#include "host/sim/track_sim.h"
+
+/** @brief   One track and where it lies on the floor.
+ *  @details The track's own origin, the middle of its left half circle, is
+ *           at (@c x, @c y) on the floor, in meters.
+ */
+struct FloorTrack
+{
+    Track track;                    ///< Shape of the track
+    float x;                        ///< Floor position of the track's origin
+    float y;                        ///< Floor position of the track's origin
+    float straight;                 ///< Length of each straight
+    float radius;                   ///< Radius of each half circle
+};
+
+/** @brief   Class which holds every track on the floor.
+ */
+class FloorMap
+{
+private:
+
+std::vector<FloorTrack> tracks;     ///< Every track on the floor
+
+public:
+
+/** @brief      Puts a track on the floor
+ *
+ *  @param      straight    Length of each straight, in meters
+ *  @param      radius      Radius of each half circle, in meters
+ *  @param      x           Floor position of the track's origin
+ *  @param      y           Floor position of the track's origin
+ *  @return     Number of the track, for placing robots on it
+ */
+size_t add_track(float straight, float radius, float x, float y);
+
+/** @brief      Returns one of the tracks on the floor
+ */
+const FloorTrack& get_track(size_t index) const { return tracks[index]; }
+
+/** @brief      Returns the number of tracks on the floor
+ */
+size_t size() const { return tracks.size(); }
+
+/** @brief      Returns true if a point of the floor is on any track's tape
+ */
+bool on_tape(float x, float y) const;
+
+/** @brief      Reads the IR array of a robot on one of the tracks
+ *  @details    The sensors are placed as in @c SimRobot::read_frame(), but
+ *              every track on the floor is looked at.
+ *
+ *  @param      robot   Robot whose array is read
+ *  @param      index   Track whose coordinates the robot's position uses
+ *  @return     Frame in the same format as IR_Array::getFrame()
+ */
+uint8_t read_frame(const SimRobot& robot, size_t index) const;
+
+}; //end class FloorMap
+
+#endif //end if: define floor map declarations
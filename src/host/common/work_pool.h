@@ -0,0 +1,156 @@
+/** @file   work_pool.h
+ *  @brief  This file contains a small work stealing thread pool used by the
+ *          PC simulation tools to run many independent simulations on all of
+ *          the computer's cores.
+ *  @details Each worker thread has its own list of jobs. A worker takes jobs
+ *           from the front of its own list and, when that runs dry, steals
+ *           from the back of another worker's list. Jobs which take very
+ *           different amounts of time (a lap that is lost after one second
+ *           versus one which finishes after a minute) are therefore spread
+ *           evenly without a single shared queue that every thread fights
+ *           over.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ */
+
+
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+#include <stddef.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** @brief   Class which runs a batch of jobs on a set of worker threads.
+ *  @details A pool is used by handing it a list of jobs with run(), which
+ *           returns once every job has finished. The threads only live for
+ *           the length of one call to run().
+ */
+class WorkPool
+{
+public:
+    /// A job is any function which takes the number of the worker running it
+    typedef std::function<void (size_t worker)> Job;
+
+private:
+    /// The jobs waiting for one worker, and the lock which protects them
+    struct WorkerQueue
+    {
+        std::mutex lock;
+        std::deque<Job> jobs;
+    };
+
+    size_t thread_count;            ///< Number of worker threads to start
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+    /** @brief   Takes a job from the front of a worker's own list.
+     */
+    bool pop_own (size_t worker, Job& job)
+    {
+        WorkerQueue& queue = *queues[worker];
+        std::lock_guard<std::mutex> guard (queue.lock);
+        if (queue.jobs.empty ())
+        {
+            return false;
+        }
+        job = std::move (queue.jobs.front ());
+        queue.jobs.pop_front ();
+        return true;
+    }
+
+    /** @brief   Takes a job from the back of another worker's list.
+     *  @details Victims are tried in turn starting with the next worker, so
+     *           thieves spread out rather than all picking on worker 0.
+     */
+    bool steal (size_t worker, Job& job)
+    {
+        for (size_t offset = 1; offset < thread_count; offset++)
+        {
+            WorkerQueue& victim = *queues[(worker + offset) % thread_count];
+            std::lock_guard<std::mutex> guard (victim.lock);
+            if (!victim.jobs.empty ())
+            {
+                job = std::move (victim.jobs.back ());
+                victim.jobs.pop_back ();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** @brief   Runs jobs until there are none left anywhere.
+     *  @details No new jobs are added while the pool runs, so once a worker
+     *           finds every list empty it can stop.
+     */
+    void worker_loop (size_t worker)
+    {
+        Job job;
+        while (pop_own (worker, job) || steal (worker, job))
+        {
+            job (worker);
+        }
+    }
+
+public:
+    /** @brief   Constructor which sets how many threads to use.
+     *  @param   threads Number of worker threads; 0 means one per core
+     */
+    explicit WorkPool (size_t threads = 0)
+    {
+        thread_count = threads;
+        if (thread_count == 0)
+        {
+            thread_count = std::thread::hardware_concurrency ();
+        }
+        if (thread_count == 0)
+        {
+            thread_count = 1;
+        }
+        for (size_t index = 0; index < thread_count; index++)
+        {
+            queues.emplace_back (new WorkerQueue);
+        }
+    }
+
+    /** @brief   Returns the number of worker threads the pool uses.
+     */
+    size_t size () const
+    {
+        return thread_count;
+    }
+
+    /** @brief   Runs every job and waits for all of them to finish.
+     *  @details Jobs are dealt out to the workers in turn, and then each
+     *           worker balances its load by stealing.
+     *  @param   jobs The jobs to run
+     */
+    void run (std::vector<Job>& jobs)
+    {
+        for (size_t index = 0; index < jobs.size (); index++)
+        {
+            queues[index % thread_count]->jobs.push_back (std::move (jobs[index]));
+        }
+        jobs.clear ();
+
+        std::vector<std::thread> threads;
+        for (size_t worker = 1; worker < thread_count; worker++)
+        {
+            threads.emplace_back (&WorkPool::worker_loop, this, worker);
+        }
+        worker_loop (0);
+        for (std::thread& thread : threads)
+        {
+            thread.join ();
+        }
+    }
+};
+
+#endif // WORK_POOL_H
@@ -0,0 +1,227 @@
+/** @file dma_sim.cpp
+ *      This file contains a PC program which checks the timer triggered DMA
+ *      capture of the IR array before it goes on the robot. The stand-in for
+ *      the DMA unit samples the simulated track at 2, 5 and 10 kHz with the
+ *      nucleo's pin map, each sensor reading wrong in a set fraction of the
+ *      samples, and the robot drives a lap on either the raw newest sample
+ *      or the majority vote over each 5 ms frame. The robot keeps moving
+ *      while a frame's samples are taken, so each sample sees the track
+ *      from the robot's pose at its own time, found by interpolating
+ *      between the poses at the start and end of the frame; a bad frame is
+ *      one which differs from what a polled read at the end of the frame
+ *      would see. Build it with <tt>pio run -e dma_sim</tt>.
+ *
+ *      Usage: <tt>dma_sim [--seed N]</tt>
+ *
+ *  @author  WC Montgomery, A Recidoro, A Haduong
+ *
+ *  @date    18 Oct 2026    Original file
+ *  @date    18 Oct 2026    Samples taken at the robot's pose at their time
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <random>
+#include "drive_logic.h"
+#include "ir_frames.h"
+#include "host/sim/sim_dma.h"
+#include "host/sim/track_sim.h"
+
+/** @brief   Where the sensors are on the Nucleo-L476RG.
+ *  @details Sensors 1, 3, 4, 6, 7 and 8 are on D2, D7, D8, D11, D12 and D13,
+ *           which are PA10, PA8, PA9, PA7, PA6 and PA5; sensors 2 and 5 are
+ *           on D4 and D10, which are PB5 and PB6.
+ */
+static const IrPinMap NUCLEO_MAP =
+{
+    {0, 1, 0, 0, 1, 0, 0, 0},
+    {10, 5, 8, 9, 6, 7, 6, 5}
+};
+
+/// Milliseconds per frame, as in task_IR_array
+static const uint32_t FRAME_MS = 5;
+
+/** @brief   Where the robot was at one time.
+ */
+struct TimedPose
+{
+    uint64_t time_us;               ///< Time of the pose
+    float x;                        ///< Position of the middle of the axle
+    float y;                        ///< Position of the middle of the axle
+    float heading;                  ///< Direction of travel in radians
+};
+
+/** @brief   Finds the robot's pose part way between two known poses.
+ *  @details The model moves in 1 ms steps, so over one 5 ms frame a
+ *           straight line between the poses is close enough.
+ */
+static TimedPose pose_between (const TimedPose& from, const TimedPose& to,
+                               uint64_t time_us)
+{
+    if (to.time_us <= from.time_us || time_us >= to.time_us)
+    {
+        return to;
+    }
+    float part = time_us <= from.time_us ? 0.0f
+               : (float)(time_us - from.time_us)
+                 / (float)(to.time_us - from.time_us);
+    float turn = remainderf (to.heading - from.heading, 2.0f * (float)M_PI);
+
+    TimedPose pose;
+    pose.time_us = time_us;
+    pose.x = from.x + part * (to.x - from.x);
+    pose.y = from.y + part * (to.y - from.y);
+    pose.heading = from.heading + part * turn;
+    return pose;
+}
+
+/** @brief   How one lap went with one way of capturing frames.
+ */
+struct CaptureResult
+{
+    LapResult lap;                  ///< How well the robot followed the tape
+    uint32_t frames;                ///< Frames given to the drive logic
+    uint32_t wrong_frames;          ///< Frames which differ from the true one
+};
+
+/** @brief   Drives one lap with frames captured by the DMA stand-in.
+ *
+ *  @param   track       Track to drive on
+ *  @param   params      Speeds and filter settings to use
+ *  @param   sample_hz   Sample rate of the capture
+ *  @param   noise       Chance of each sensor reading wrong in each sample
+ *  @param   use_majority True to vote over each frame, false to use the
+ *                        newest sample only, as a polled read would
+ *  @param   seed        Seed for the noise, so every run sees the same noise
+ */
+static CaptureResult capture_lap (const Track& track, const RobotParams& params,
+                                  uint32_t sample_hz, float noise,
+                                  bool use_majority, uint32_t seed)
+{
+    std::mt19937 random (seed);
+    std::bernoulli_distribution flip (noise);
+
+    CaptureResult result = {};
+    TimedPose frame_start = {};
+    TimedPose frame_end = {};
+    uint8_t frame = 0;
+
+    SimDmaCapture::Sampler sampler =
+        [&] (uint64_t sample_us, uint16_t& port_0, uint16_t& port_1)
+    {
+        TimedPose pose = pose_between (frame_start, frame_end, sample_us);
+        uint8_t seen = SimRobot::frame_at (track, pose.x, pose.y,
+                                           pose.heading);
+        for (uint8_t sensor = 0; sensor < 8; sensor++)
+        {
+            if (flip (random))
+            {
+                seen ^= 1 << sensor;
+            }
+        }
+        unpack_ir_sample (NUCLEO_MAP, seen, port_0, port_1);
+    };
+
+    SimDmaCapture::HalfHandler handler =
+        [&] (const uint16_t* p_port_0, const uint16_t* p_port_1,
+             uint16_t count)
+    {
+        if (use_majority)
+        {
+            frame = majority_frame (NUCLEO_MAP, p_port_0, p_port_1, count);
+        }
+        else
+        {
+            frame = pack_ir_sample (NUCLEO_MAP, p_port_0[count - 1],
+                                    p_port_1[count - 1]);
+        }
+    };
+
+    uint16_t samples_per_frame = (uint16_t)(sample_hz * FRAME_MS / 1000);
+    SimDmaCapture capture (sample_hz, samples_per_frame, sampler, handler);
+
+    FrameSource source = [&] (const SimRobot& robot, const Track& track)
+    {
+        // the samples due now were taken while the robot moved here from
+        // where it was at the last frame
+        frame_end.time_us = (uint64_t)robot.get_time_ms () * 1000;
+        frame_end.x = robot.get_x ();
+        frame_end.y = robot.get_y ();
+        frame_end.heading = robot.get_heading ();
+        if (result.frames == 0)
+        {
+            frame_start = frame_end;
+        }
+        capture.advance_to (frame_end.time_us);
+        frame_start = frame_end;
+        result.frames++;
+        if (frame != robot.read_frame (track))
+        {
+            result.wrong_frames++;
+        }
+        return frame;
+    };
+
+    result.lap = run_lap (track, params, 60.0f, 0.15f, source);
+    return result;
+}
+
+/** @brief   Prints one line of the results table.
+ */
+static void print_result (const char* method, uint32_t sample_hz, float noise,
+                          const CaptureResult& result)
+{
+    printf ("%-9s%7lu%8.0f%%  %-5s%8.2f%10.1f%11.1f%%\n", method,
+            (unsigned long)sample_hz, noise * 100.0f,
+            result.lap.finished ? "yes" : "no",
+            result.lap.finished ? result.lap.lap_time : result.lap.distance,
+            result.lap.rms_error * 1000.0f,
+            result.frames ? 100.0f * result.wrong_frames / result.frames
+                          : 0.0f);
+}
+
+
+/** @brief   Runs a lap for every sample rate, noise level and capture method.
+ */
+int main (int argc, char** argv)
+{
+    uint32_t seed = 507;
+    for (int index = 1; index < argc; index++)
+    {
+        if (strcmp (argv[index], "--seed") == 0 && index + 1 < argc)
+        {
+            seed = (uint32_t)strtoul (argv[++index], NULL, 10);
+        }
+        else
+        {
+            fprintf (stderr, "Usage: %s [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Track track;
+    RobotParams params;
+    params.sim_A = 0.5f;
+
+    const uint32_t rates[] = {2000, 5000, 10000};
+    const float noises[] = {0.01f, 0.05f, 0.10f};
+
+    printf ("Time column is the lap time in s, or meters driven if lost\n");
+    printf ("Method      Rate   Noise  Lap   Time/m  RMS mm  Bad frames\n");
+    for (uint32_t rate : rates)
+    {
+        for (float noise : noises)
+        {
+            print_result ("newest", rate, noise,
+                          capture_lap (track, params, rate, noise, false,
+                                       seed));
+            print_result ("majority", rate, noise,
+                          capture_lap (track, params, rate, noise, true,
+                                       seed));
+        }
+    }
+    return 0;
+}
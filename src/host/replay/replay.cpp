@@ -0,0 +1,300 @@
+/** @file replay.cpp
+ *      This file contains a PC program which plays a recorded CleanBot trace
+ *      back through the same decision logic that runs on the nucleo. It runs
+ *      as fast as the PC can go and always gives the same motor commands for
+ *      the same trace, so the output of two firmware revisions can be
+ *      compared with @c diff. Build it with <tt>pio run -e replay</tt>.
+ *
+ *      Usage: <tt>replay [--no-timing] [--max-speed N] trace_file</tt>
+ *
+ *      The trace file may be the raw binary trace or a serial monitor log
+ *      containing the @c TRACE: lines printed by a @c CLEANBOT_RECORD build.
+ *      A log holds one dump for each time a trace buffer filled, each with
+ *      its own header; the dumps are read one after another with the same
+ *      replay state, since the firmware's state carried on between them.
+ *      The encoder records are turned into odometry for a route map, as the
+ *      encoder task does, so the speeds come from @c route_drive() just as
+ *      they do in the IR array task, held down to the speed which the lamp
+ *      records say the coverage grid allowed. One CSV line is printed for
+ *      each IR frame; a summary of how long the logic took per frame and
+ *      what the route map learned is printed to @c stderr. A damaged dump
+ *      is reported and makes the program fail once the rest are replayed.
+ *
+ *  @author  WC Montgomery, A Recidoro, A Haduong
+ *
+ *  @date    18 Oct 2026    Original file
+ *  @date    18 Oct 2026    Drive states chosen by the line tracker, as in
+ *                          the firmware
+ *  @date    18 Oct 2026    Odometry and the route map choose the speeds, as
+ *                          in the firmware
+ *  @date    18 Oct 2026    The lamp's recorded speed limit is applied
+ *  @date    18 Oct 2026    Every dump in a log is replayed, and damaged
+ *                          dumps are reported
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "drive_logic.h"
+#include "odometry.h"
+#include "route_map.h"
+#include "trace.h"
+
+
+/** @brief   Turns one hexadecimal digit into its value.
+ *  @return  The value of the digit, or -1 if it isn't a hex digit
+ */
+static int hex_value (char digit)
+{
+    if (digit >= '0' && digit <= '9') return digit - '0';
+    if (digit >= 'A' && digit <= 'F') return digit - 'A' + 10;
+    if (digit >= 'a' && digit <= 'f') return digit - 'a' + 10;
+    return -1;
+}
+
+/** @brief   Loads the dumps of a trace from a binary file or a serial
+ *           monitor log.
+ *  @details Every dump printed by the firmware starts on a new @c TRACE:
+ *           line with its own header, so a line which starts with a header
+ *           starts a new dump.
+ *  @param   file_name Name of the file to read
+ *  @param   dumps Filled with the bytes of each dump in the file
+ *  @return  True if the file could be read
+ */
+static bool load_trace (const char* file_name,
+                        std::vector<std::vector<uint8_t>>& dumps)
+{
+    std::ifstream file (file_name, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    std::vector<uint8_t> contents ((std::istreambuf_iterator<char> (file)),
+                                   std::istreambuf_iterator<char> ());
+
+    // A binary trace starts with its header, so use it as it is
+    TraceReader check (contents.data (), contents.size ());
+    if (check.valid ())
+    {
+        dumps.push_back (std::vector<uint8_t> ());
+        dumps.back ().swap (contents);
+        return true;
+    }
+
+    // Otherwise pick the hex out of every line which starts with TRACE:
+    std::string text (contents.begin (), contents.end ());
+    size_t start = 0;
+    std::vector<uint8_t> line;
+    while ((start = text.find ("TRACE:", start)) != std::string::npos)
+    {
+        line.clear ();
+        size_t index = start + 6;
+        while (index + 1 < text.size ())
+        {
+            int high = hex_value (text[index]);
+            int low = hex_value (text[index + 1]);
+            if (high < 0 || low < 0)
+            {
+                break;
+            }
+            line.push_back ((uint8_t)(high << 4 | low));
+            index += 2;
+        }
+        start = index;
+
+        TraceReader header (line.data (), line.size ());
+        if (header.valid () || dumps.empty ())
+        {
+            dumps.push_back (std::vector<uint8_t> ());
+        }
+        dumps.back ().insert (dumps.back ().end (), line.begin (), line.end ());
+    }
+    return true;
+}
+
+
+/** @brief   Reads a trace and plays it back through the drive logic.
+ */
+int main (int argc, char** argv)
+{
+    bool show_timing = true;
+    DriveParams params;
+    const char* file_name = NULL;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (strcmp (argv[arg], "--no-timing") == 0)
+        {
+            show_timing = false;
+        }
+        else if (strcmp (argv[arg], "--max-speed") == 0 && arg + 1 < argc)
+        {
+            params.max_speed = (uint8_t)atoi (argv[++arg]);
+        }
+        else
+        {
+            file_name = argv[arg];
+        }
+    }
+    if (file_name == NULL)
+    {
+        fprintf (stderr, "Usage: %s [--no-timing] [--max-speed N] trace\n",
+                 argv[0]);
+        return 2;
+    }
+
+    std::vector<std::vector<uint8_t>> dumps;
+    if (!load_trace (file_name, dumps))
+    {
+        fprintf (stderr, "Can't read %s\n", file_name);
+        return 1;
+    }
+    if (dumps.empty ())
+    {
+        fprintf (stderr, "%s doesn't hold a CleanBot trace\n", file_name);
+        return 1;
+    }
+
+    // State which the firmware keeps in its tasks and shares
+    bool wifi_flag = false;
+    LineTracker tracker;
+    const OdometryParams odometry_params;
+    Odometry odometry = {};
+    // The map is over 1 KB, so it isn't put on the stack
+    static RouteMap route_map;
+    bool lamp_on = false;
+    uint8_t lamp_percent = 100;
+    uint8_t drive_state = 0xFF;
+    int16_t left_speed = 0;
+    int16_t right_speed = 0;
+    bool commanded = false;
+
+    // Statistics about the replay
+    uint32_t damaged = 0;
+    uint32_t frames = 0;
+    uint32_t mismatches = 0;
+    uint64_t total_ns = 0;
+    uint64_t worst_ns = 0;
+
+    printf ("time_us,frame,state,commanded,left,right%s\n",
+            show_timing ? ",compute_ns" : "");
+
+    for (size_t dump = 0; dump < dumps.size (); dump++)
+    {
+        TraceReader reader (dumps[dump].data (), dumps[dump].size ());
+        if (!reader.valid ())
+        {
+            fprintf (stderr, "Dump %zu doesn't start with a trace header\n",
+                     dump + 1);
+            damaged++;
+            continue;
+        }
+
+        TraceEvent event;
+        while (reader.next (event))
+        {
+            switch (event.type)
+            {
+                case TRACE_WIFI:
+                    // The drive task acts on the new signal without waiting
+                    // for the next IR frame, using the speeds it was last
+                    // sent
+                    wifi_flag = event.wifi;
+                    commanded = wifi_flag && drive_state != 0xFF;
+                    break;
+
+                case TRACE_MOTORS:
+                    // The firmware records the speeds it gave the motors, so
+                    // check that this build would have given the same speeds
+                    if (!commanded || event.left != left_speed
+                        || event.right != right_speed)
+                    {
+                        mismatches++;
+                    }
+                    break;
+
+                case TRACE_LAMP:
+                    // The IR array task reads the LED task's latest status
+                    lamp_on = event.lamp_on;
+                    lamp_percent = event.speed_percent;
+                    break;
+
+                case TRACE_ENCODERS:
+                    // This is the work which the encoder task does
+                    update_odometry (odometry, event.left, event.right,
+                                     odometry_params);
+                    break;
+
+                case TRACE_IR_FRAME:
+                {
+                    // This is the work which task_IR_array and
+                    // task_drive_train do for each frame
+                    auto begin = std::chrono::steady_clock::now ();
+                    LineFeatures features =
+                        extract_line_features (event.frame);
+                    drive_state = track_line (tracker, event.frame,
+                                              features);
+                    route_map.update (odometry, features.kind);
+                    RouteAdvice advice = route_map.advise ();
+                    if (lamp_on && lamp_percent < advice.speed_percent)
+                    {
+                        advice.speed_percent = lamp_percent;
+                    }
+                    drive_state = route_drive (advice, drive_state, params,
+                                               left_speed, right_speed);
+                    commanded = wifi_flag && drive_state != 0xFF;
+                    auto end = std::chrono::steady_clock::now ();
+
+                    uint64_t ns = std::chrono::duration_cast<
+                        std::chrono::nanoseconds> (end - begin).count ();
+                    total_ns += ns;
+                    if (ns > worst_ns)
+                    {
+                        worst_ns = ns;
+                    }
+                    frames++;
+
+                    printf ("%u,0x%02X,%d,%d,%d,%d", event.time_us,
+                            event.frame, drive_state == 0xFF ? -1 : drive_state,
+                            commanded ? 1 : 0, left_speed, right_speed);
+                    if (show_timing)
+                    {
+                        printf (",%llu", (unsigned long long)ns);
+                    }
+                    printf ("\n");
+                    break;
+                }
+            }
+        }
+        if (reader.damaged ())
+        {
+            fprintf (stderr, "Dump %zu is damaged; the rest of it is "
+                     "skipped\n", dump + 1);
+            damaged++;
+        }
+    }
+
+    fprintf (stderr, "%zu dumps, %u frames", dumps.size (), frames);
+    if (frames > 0)
+    {
+        fprintf (stderr, ", %.1f ns mean, %llu ns worst per frame",
+                 (double)total_ns / frames, (unsigned long long)worst_ns);
+    }
+    fprintf (stderr, ", %u recorded motor commands differ\n",
+             mismatches);
+    fprintf (stderr, "Route map %s: %lu laps, %lu relearns, %lu resyncs, "
+             "learned lap %lu mm\n",
+             route_map.get_mode () == ROUTE_FOLLOWING ? "following"
+                                                      : "learning",
+             (unsigned long)route_map.get_laps (),
+             (unsigned long)route_map.get_relearns (),
+             (unsigned long)route_map.get_resyncs (),
+             (unsigned long)route_map.get_lap_mm ());
+    return damaged > 0 ? 1 : 0;
+}
@@ -0,0 +1,295 @@
+/** @file route_sim.cpp
+ *      This file contains a PC program which checks the route map before it
+ *      goes on the robot. A simulated CleanBot drives lap after lap of a
+ *      taped track, once purely reactively and once with the route map, at
+ *      the same speeds. Part way through, the track is changed to one with
+ *      longer straights, which the map must notice and learn again. Each
+ *      lap's time and tracking error are printed with the map's state at
+ *      the end of the lap. A last session drives the first track only, and
+ *      the program fails if the map relearned or overflowed there, since
+ *      nothing changed. The speeds are the firmware's own unless they are
+ *      given. The motor filter is a faster one than the firmware's, with
+ *      which the robot can follow the track; with the firmware's filter,
+ *      <tt>--filter 0.99</tt>, the motors answer too slowly for any robot to
+ *      stay on the line. Build it with <tt>pio run -e route_sim</tt>.
+ *
+ *      Usage: <tt>route_sim [--laps N] [--change N] [--speed 0-255]
+ *             [--cruise %] [--turn %] [--spin %] [--filter sim_A]
+ *             [--brake %] [--lookahead mm]</tt>
+ *
+ *  @author  WC Montgomery, A Recidoro, A Haduong
+ *
+ *  @date    18 Oct 2026    Original file
+ *  @date    18 Oct 2026    Firmware speeds; checks that an unchanged track
+ *                          is never learned again
+ *  @date    18 Oct 2026    Motor filter of 0.8 unless another is given
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "drive_logic.h"
+#include "route_map.h"
+#include "host/sim/track_sim.h"
+
+/// Distance from the tape at which the line counts as lost, in meters
+static const float LOST_LIMIT = 0.15f;
+
+/// Seconds allowed for one lap before giving up
+static const float LAP_TIME_LIMIT = 60.0f;
+
+/** @brief   How one lap of a session went.
+ */
+struct SessionLap
+{
+    LapResult lap;                  ///< Time and tracking error
+    RouteMode mode;                 ///< Route map's mode at the end of the lap
+    uint32_t relearns;              ///< Route changes noticed so far
+};
+
+/** @brief   Drives laps one after another without stopping.
+ *  @details The robot drives @p change_lap laps of the first track and then
+ *           the rest on the second. Both tracks start at the same place,
+ *           so the robot carries straight on when the track is changed.
+ *
+ *  @param   first       Track for the first laps
+ *  @param   second      Track for the laps after the change
+ *  @param   params      Speeds and filter settings to use
+ *  @param   laps        Number of laps to drive
+ *  @param   change_lap  Number of laps before the track is changed
+ *  @param   p_map       Route map to use, or NULL to drive reactively
+ *  @return  One entry per lap; the last one is unfinished if the line was
+ *           lost
+ */
+static std::vector<SessionLap> drive_session (const Track& first,
+                                              const Track& second,
+                                              const RobotParams& params,
+                                              uint32_t laps,
+                                              uint32_t change_lap,
+                                              RouteMap* p_map)
+{
+    float x, y, heading;
+    first.pose_at (0.0f, x, y, heading);
+    x -= SimRobot::SENSOR_OFFSET * cosf (heading);
+    y -= SimRobot::SENSOR_OFFSET * sinf (heading);
+    SimRobot robot (params, x, y, heading);
+    robot.set_route_map (p_map);
+
+    std::vector<SessionLap> session;
+    const Track* p_track = &first;
+    float sx, sy, last_progress;
+    robot.sensor_center (sx, sy);
+    p_track->nearest (sx, sy, last_progress);
+
+    for (uint32_t lap = 0; lap < laps; lap++)
+    {
+        if (lap == change_lap)
+        {
+            p_track = &second;
+            robot.sensor_center (sx, sy);
+            p_track->nearest (sx, sy, last_progress);
+        }
+        const float length = p_track->length ();
+
+        SessionLap result = {};
+        result.lap.lap_time = LAP_TIME_LIMIT;
+        uint32_t start_ms = robot.get_time_ms ();
+        uint32_t limit_ms = start_ms + (uint32_t)(LAP_TIME_LIMIT * 1000.0f);
+        double error_squared = 0.0;
+        uint32_t samples = 0;
+        bool lost = false;
+
+        while (robot.get_time_ms () < limit_ms)
+        {
+            robot.step (*p_track);
+
+            float progress;
+            robot.sensor_center (sx, sy);
+            float error = p_track->nearest (sx, sy, progress);
+            float moved = progress - last_progress;
+            if (moved > 0.5f * length)
+            {
+                moved -= length;
+            }
+            else if (moved < -0.5f * length)
+            {
+                moved += length;
+            }
+            result.lap.distance += moved;
+            last_progress = progress;
+
+            error_squared += (double)error * error;
+            samples++;
+            if (error > result.lap.max_error)
+            {
+                result.lap.max_error = error;
+            }
+            if (error > LOST_LIMIT)
+            {
+                lost = true;
+                break;
+            }
+            if (result.lap.distance >= length)
+            {
+                result.lap.finished = true;
+                result.lap.lap_time =
+                    (robot.get_time_ms () - start_ms) / 1000.0f;
+                break;
+            }
+        }
+
+        result.lap.rms_error = samples
+            ? (float)sqrt (error_squared / samples) : 0.0f;
+        result.mode = p_map ? p_map->get_mode () : ROUTE_LEARNING;
+        result.relearns = p_map ? p_map->get_relearns () : 0;
+        session.push_back (result);
+        if (lost || !result.lap.finished)
+        {
+            break;
+        }
+    }
+    return session;
+}
+
+/** @brief   Prints the laps of one session with the averages of the laps
+ *           which the map could use.
+ */
+static void print_session (const char* p_title,
+                           const std::vector<SessionLap>& session,
+                           bool show_map)
+{
+    printf ("%s\n", p_title);
+    printf (" lap  lap_s  rms_mm  max_mm%s\n",
+            show_map ? "  map        relearns" : "");
+
+    float total = 0.0f;
+    uint32_t counted = 0;
+    for (size_t lap = 0; lap < session.size (); lap++)
+    {
+        const SessionLap& entry = session[lap];
+        if (!entry.lap.finished)
+        {
+            printf ("%4zu  lost after %.2f m\n", lap + 1, entry.lap.distance);
+            continue;
+        }
+        printf ("%4zu  %5.2f  %6.2f  %6.2f", lap + 1, entry.lap.lap_time,
+                entry.lap.rms_error * 1000.0f,
+                entry.lap.max_error * 1000.0f);
+        if (show_map)
+        {
+            printf ("  %-10s %8lu",
+                    entry.mode == ROUTE_FOLLOWING ? "following" : "learning",
+                    (unsigned long)entry.relearns);
+        }
+        printf ("\n");
+        total += entry.lap.lap_time;
+        counted++;
+    }
+    if (counted > 0)
+    {
+        printf ("mean lap %.2f s over %lu laps\n\n", total / counted,
+                (unsigned long)counted);
+    }
+}
+
+
+/** @brief   Drives both sessions and prints how they went.
+ */
+int main (int argc, char** argv)
+{
+    uint32_t laps = 10;
+    uint32_t change_lap = 5;
+    // The firmware's own speeds, with a motor filter the robot can steer by
+    RobotParams params;
+    params.sim_A = 0.8f;
+    RouteParams route_params;
+
+    for (int arg = 1; arg + 1 < argc; arg += 2)
+    {
+        if (strcmp (argv[arg], "--laps") == 0)
+        {
+            laps = (uint32_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--change") == 0)
+        {
+            change_lap = (uint32_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--speed") == 0)
+        {
+            params.drive.max_speed = (uint8_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--cruise") == 0)
+        {
+            params.drive.cruise_percent = (uint8_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--turn") == 0)
+        {
+            params.drive.turn_percent = (uint8_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--spin") == 0)
+        {
+            params.drive.spin_percent = (uint8_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--filter") == 0)
+        {
+            params.sim_A = (float)atof (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--brake") == 0)
+        {
+            route_params.brake_percent = (uint8_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--lookahead") == 0)
+        {
+            route_params.lookahead_mm = (uint16_t)atoi (argv[arg + 1]);
+        }
+        else
+        {
+            fprintf (stderr, "Unknown option %s\n", argv[arg]);
+            return 2;
+        }
+    }
+
+    Track first (2.0f, 0.5f);
+    Track second (3.0f, 0.5f);
+    printf ("Track %.2f m, changed to %.2f m after lap %lu; speed %u, "
+            "cruise %u%%, turn %u%%, spin %u%%, filter %.2f, brake %u%%\n\n",
+            first.length (), second.length (), (unsigned long)change_lap,
+            params.drive.max_speed, params.drive.cruise_percent,
+            params.drive.turn_percent, params.drive.spin_percent,
+            params.sim_A, route_params.brake_percent);
+
+    std::vector<SessionLap> reactive =
+        drive_session (first, second, params, laps, change_lap, NULL);
+    print_session ("Reactive", reactive, false);
+
+    // The maps are over 1 KB, so they aren't put on the stack
+    static RouteMap map (route_params);
+    std::vector<SessionLap> learned =
+        drive_session (first, second, params, laps, change_lap, &map);
+    print_session ("Route map", learned, true);
+    printf ("Route map: %lu laps closed, %lu relearns, %lu resyncs, "
+            "%lu overflows, learned lap %.2f m\n\n",
+            (unsigned long)map.get_laps (), (unsigned long)map.get_relearns (),
+            (unsigned long)map.get_resyncs (),
+            (unsigned long)map.get_overflows (), map.get_lap_mm () / 1000.0f);
+
+    // The same laps with the track never changed, which must not be learned
+    // again; it must also be driven long enough to be checked
+    static RouteMap unchanged (route_params);
+    std::vector<SessionLap> same =
+        drive_session (first, second, params, laps, laps, &unchanged);
+    print_session ("Route map, no change", same, true);
+    bool checked = same.size () == laps && same.back ().lap.finished
+                   && unchanged.get_mode () == ROUTE_FOLLOWING;
+    bool passed = checked && unchanged.get_relearns () == 0
+                  && unchanged.get_overflows () == 0;
+    printf ("No change: %lu relearns, %lu overflows%s -- %s\n",
+            (unsigned long)unchanged.get_relearns (),
+            (unsigned long)unchanged.get_overflows (),
+            checked ? "" : ", line lost before every lap was driven",
+            passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
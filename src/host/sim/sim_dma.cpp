@@ -0,0 +1,51 @@
+/** @file   sim_dma.cpp
+ *  @brief  This file contains the definitions of the PC stand-in for the IR
+ *          array DMA capture.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ */
+
+#include "sim_dma.h"
+
+
+/** @brief   Constructor which sets up the buffers and the sample rate.
+ */
+SimDmaCapture::SimDmaCapture (uint32_t samples_per_sec,
+                              uint16_t samples_per_half,
+                              const Sampler& sample,
+                              const HalfHandler& handler)
+    : sample_hz (samples_per_sec), half_length (samples_per_half),
+      port_0 (2 * samples_per_half), port_1 (2 * samples_per_half),
+      sampler (sample), on_half (handler), samples_taken (0),
+      halves_done (0)
+{
+}
+
+
+/** @brief   Takes every sample which is due up to a time.
+ *  @details Sample @c n is taken at <tt>n * 1e6 / sample_hz</tt> us, the way
+ *           the timer's update events are spaced. Each sample goes into the
+ *           next slot of the circular buffers, and the handler is called
+ *           when the slot written was the last one in either half.
+ */
+void SimDmaCapture::advance_to (uint64_t time_us)
+{
+    while (samples_taken * 1000000ULL / sample_hz <= time_us)
+    {
+        uint64_t sample_us = samples_taken * 1000000ULL / sample_hz;
+        size_t slot = samples_taken % (2 * half_length);
+        sampler (sample_us, port_0[slot], port_1[slot]);
+        samples_taken++;
+
+        if (slot == half_length - 1u || slot == 2u * half_length - 1u)
+        {
+            size_t start = slot + 1 - half_length;
+            on_half (&port_0[start], &port_1[start], half_length);
+            halves_done++;
+        }
+    }
+}
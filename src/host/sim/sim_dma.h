@@ -0,0 +1,76 @@
+/** @file   sim_dma.h
+ *  @brief  This file contains a PC stand-in for the timer triggered DMA
+ *          capture of the IR array in ir_dma.cpp.
+ *  @details The stand-in fills two circular buffers with samples of two GPIO
+ *           ports at a fixed rate and calls a function each time half of the
+ *           buffers has been filled, just as the DMA half and full transfer
+ *           interrupts wake the IR task on the nucleo. The port values come
+ *           from a sampler function, so tests can model the track, noise or
+ *           glitches however they like.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ */
+
+
+#ifndef SIM_DMA_H
+#define SIM_DMA_H
+
+#include <stdint.h>
+#include <functional>
+#include <vector>
+
+/** @brief   Class which models the timer, DMA channels and circular buffers
+ *           of the IR capture unit.
+ */
+class SimDmaCapture
+{
+public:
+    /// Supplies the value of both ports' input registers at a time in us
+    typedef std::function<void (uint64_t time_us, uint16_t& port_0,
+                                uint16_t& port_1)> Sampler;
+
+    /// Called with the samples of one half of the buffers once it is full
+    typedef std::function<void (const uint16_t* p_port_0,
+                                const uint16_t* p_port_1,
+                                uint16_t count)> HalfHandler;
+
+private:
+    uint32_t sample_hz;             ///< Samples per second
+    uint16_t half_length;           ///< Samples in each half of the buffers
+    std::vector<uint16_t> port_0;   ///< Circular buffer for the first port
+    std::vector<uint16_t> port_1;   ///< Circular buffer for the second port
+    Sampler sampler;                ///< Where the samples come from
+    HalfHandler on_half;            ///< What to do with each half
+    uint64_t samples_taken;         ///< Samples taken since the start
+    uint32_t halves_done;           ///< Number of halves handed over
+
+public:
+    /** @brief   Constructor which sets up the buffers and the sample rate.
+     *  @param   samples_per_sec Sample rate, like @c IR_DMA_SAMPLE_HZ
+     *  @param   samples_per_half Samples in each half, one frame's worth
+     *  @param   sample Function which supplies the port values
+     *  @param   handler Function which is given each full half
+     */
+    SimDmaCapture (uint32_t samples_per_sec, uint16_t samples_per_half,
+                   const Sampler& sample, const HalfHandler& handler);
+
+    /** @brief   Takes every sample which is due up to a time.
+     *  @details The handler is called from inside this function whenever a
+     *           half of the buffers fills, as the DMA interrupt would be.
+     *  @param   time_us Time to run the capture up to, in microseconds
+     */
+    void advance_to (uint64_t time_us);
+
+    /** @brief   Returns the number of halves handed over so far.
+     */
+    uint32_t halves () const
+    {
+        return halves_done;
+    }
+};
+
+#endif // SIM_DMA_H
@@ -0,0 +1,364 @@
+/** @file   track_sim.cpp
+ *  @brief  This file contains the definitions of the PC model of a CleanBot
+ *          following a taped track.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ */
+
+#include <math.h>
+#include "track_sim.h"
+
+/// Half a turn, in radians
+static const float PI = 3.14159265f;
+
+const float SimRobot::SENSOR_OFFSET = 0.07f;
+const float SimRobot::SENSOR_PITCH = 0.009525f;
+const float SimRobot::WHEEL_BASE = 0.14f;
+const float SimRobot::TOP_SPEED = 0.6f;
+const float SimRobot::MOTOR_TAU = 0.03f;
+
+/// Milliseconds between reads of the IR array, as in task_IR_array
+static const uint32_t IR_PERIOD_MS = 5;
+
+/// Milliseconds between runs of the LED task, which exposes the grid
+static const uint32_t LED_PERIOD_MS = COVERAGE_DOSE_MS;
+
+/// Milliseconds between steps of the motor filter, as in ChangeSpeed()
+static const uint32_t FILTER_PERIOD_MS = 50;
+
+
+/** @brief      Constructor which sets the size of the track
+ *
+ *  @param      straight_length Length of each straight
+ *  @param      curve_radius    Radius of each half circle
+ *  @param      tape            Width of the tape
+ */
+Track::Track(float straight_length, float curve_radius, float tape)
+    : straight(straight_length), radius(curve_radius), tape_width(tape)
+{
+}
+
+/** @brief      Returns the length of one lap along the middle of the tape
+ */
+float Track::length() const
+{
+    return 2.0f * straight + 2.0f * PI * radius;
+}
+
+/** @brief      Finds the point on the middle of the tape nearest a point
+ *  @details    The bottom straight runs from (0, -radius) to
+ *              (straight, -radius), the right half circle is centered on
+ *              (straight, 0), the top straight runs back to (0, radius) and
+ *              the left half circle is centered on the origin.
+ */
+float Track::nearest(float x, float y, float& progress) const
+{
+    float clamped = x < 0.0f ? 0.0f : (x > straight ? straight : x);
+
+    // Bottom straight
+    float best = hypotf(x - clamped, y + radius);
+    progress = clamped;
+
+    // Top straight, driven from right to left
+    float distance = hypotf(x - clamped, y - radius);
+    if (distance < best)
+    {
+        best = distance;
+        progress = straight + PI * radius + (straight - clamped);
+    }
+
+    // Right half circle, from the bottom straight round to the top one
+    if (x > straight)
+    {
+        float dx = x - straight;
+        distance = fabsf(hypotf(dx, y) - radius);
+        if (distance < best)
+        {
+            best = distance;
+            progress = straight + radius * (atan2f(y, dx) + 0.5f * PI);
+        }
+    }
+
+    // Left half circle, from the top straight round to the start
+    if (x < 0.0f)
+    {
+        distance = fabsf(hypotf(x, y) - radius);
+        if (distance < best)
+        {
+            float angle = atan2f(y, x);
+            if (angle < 0.0f)
+            {
+                angle += 2.0f * PI;
+            }
+            best = distance;
+            progress = 2.0f * straight + PI * radius
+                       + radius * (angle - 0.5f * PI);
+        }
+    }
+
+    return best;
+}
+
+/** @brief      Returns true if a sensor at the given point is over the tape
+ */
+bool Track::on_tape(float x, float y) const
+{
+    float progress;
+    return nearest(x, y, progress) <= 0.5f * tape_width;
+}
+
+/** @brief      Finds the position and heading at a distance along the track
+ */
+void Track::pose_at(float progress, float& x, float& y, float& heading) const
+{
+    progress = fmodf(progress, length());
+    if (progress < 0.0f)
+    {
+        progress += length();
+    }
+
+    float curve = PI * radius;
+    if (progress < straight)
+    {
+        x = progress;
+        y = -radius;
+        heading = 0.0f;
+    }
+    else if (progress < straight + curve)
+    {
+        float angle = (progress - straight) / radius - 0.5f * PI;
+        x = straight + radius * cosf(angle);
+        y = radius * sinf(angle);
+        heading = angle + 0.5f * PI;
+    }
+    else if (progress < 2.0f * straight + curve)
+    {
+        x = straight - (progress - straight - curve);
+        y = radius;
+        heading = PI;
+    }
+    else
+    {
+        float angle = (progress - 2.0f * straight - curve) / radius + 0.5f * PI;
+        x = radius * cosf(angle);
+        y = radius * sinf(angle);
+        heading = angle + 0.5f * PI;
+    }
+}
+
+
+/** @brief      Constructor which places the robot on the track
+ */
+SimRobot::SimRobot(const RobotParams& robot_params, float start_x,
+                   float start_y, float start_heading)
+    : params(robot_params), x(start_x), y(start_y), heading(start_heading),
+      left_wheel(0.0f), right_wheel(0.0f), left_filtered(0.0f),
+      right_filtered(0.0f), left_target(0), right_target(0),
+      last_frame(0), time_ms(0), left_travel(0.0), right_travel(0.0),
+      odometry_params(), odometry(), p_route(NULL), p_coverage(NULL),
+      dose_speed(false)
+{
+}
+
+/** @brief      Returns the left encoder count, as the firmware would read it
+ */
+int32_t SimRobot::get_left_count() const
+{
+    return (int32_t)floor(left_travel * 1000.0 / odometry_params.mm_per_count);
+}
+
+/** @brief      Returns the right encoder count, as the firmware would read it
+ */
+int32_t SimRobot::get_right_count() const
+{
+    return (int32_t)floor(right_travel * 1000.0
+                          / odometry_params.mm_per_count);
+}
+
+/** @brief      Finds the middle of the IR array
+ */
+void SimRobot::sensor_center(float& sx, float& sy) const
+{
+    sx = x + SENSOR_OFFSET * cosf(heading);
+    sy = y + SENSOR_OFFSET * sinf(heading);
+}
+
+/** @brief      Reads the simulated IR array
+ */
+uint8_t SimRobot::read_frame(const Track& track) const
+{
+    return frame_at(track, x, y, heading);
+}
+
+/** @brief      Reads the IR array of a robot at any pose
+ *  @details    Sensor 8 is on the driver (left) side and sensor 1 on the
+ *              passenger (right) side, 9.525 mm apart.
+ */
+uint8_t SimRobot::frame_at(const Track& track, float axle_x, float axle_y,
+                           float axle_heading)
+{
+    float sx = axle_x + SENSOR_OFFSET * cosf(axle_heading);
+    float sy = axle_y + SENSOR_OFFSET * sinf(axle_heading);
+
+    // Unit vector pointing to the robot's left
+    float left_x = -sinf(axle_heading);
+    float left_y = cosf(axle_heading);
+
+    uint8_t frame = 0;
+    for (uint8_t sensor = 0; sensor < 8; sensor++)
+    {
+        float offset = ((float)sensor - 3.5f) * SENSOR_PITCH;
+        if (track.on_tape(sx + offset * left_x, sy + offset * left_y))
+        {
+            frame |= 1 << sensor;
+        }
+    }
+    return frame;
+}
+
+/** @brief      Moves the model forward by 1 ms
+ */
+void SimRobot::step(const Track& track, bool enabled)
+{
+    const float dt = 0.001f;
+
+    // The vision and drive train tasks
+    if (time_ms % IR_PERIOD_MS == 0)
+    {
+        last_frame = frame_source ? frame_source(*this, track)
+                                  : read_frame(track);
+        features = extract_line_features(last_frame);
+        uint8_t drive_state = track_line(tracker, last_frame, features);
+
+        // The encoder task and the route map
+        update_odometry(odometry, get_left_count(), get_right_count(),
+                        odometry_params);
+        RouteAdvice advice = {100, 100, 0};
+        if (p_route != NULL)
+        {
+            p_route->update(odometry, features.kind);
+            advice = p_route->advise();
+        }
+        if (p_coverage != NULL && dose_speed)
+        {
+            uint8_t percent = p_coverage->speed_percent(odometry);
+            if (percent < advice.speed_percent)
+            {
+                advice.speed_percent = percent;
+            }
+        }
+        if (enabled)
+        {
+            route_drive(advice, drive_state, params.drive, left_target,
+                        right_target);
+        }
+    }
+
+    // The LED task
+    if (p_coverage != NULL && time_ms % LED_PERIOD_MS == 0)
+    {
+        p_coverage->expose(odometry, enabled);
+    }
+
+    // The filter inside the motor driver
+    if (time_ms % FILTER_PERIOD_MS == 0)
+    {
+        left_filtered = filter_speed(left_filtered, left_target, params.sim_A);
+        right_filtered = filter_speed(right_filtered, right_target,
+                                      params.sim_A);
+    }
+
+    // The motors, which take a little while to reach the speed asked for
+    float left_goal = (left_target < 0 ? -left_filtered : left_filtered)
+                      * TOP_SPEED / 255.0f;
+    float right_goal = (right_target < 0 ? -right_filtered : right_filtered)
+                       * TOP_SPEED / 255.0f;
+    left_wheel += (left_goal - left_wheel) * dt / MOTOR_TAU;
+    right_wheel += (right_goal - right_wheel) * dt / MOTOR_TAU;
+
+    // Differential drive kinematics
+    float speed = 0.5f * (left_wheel + right_wheel);
+    float turn_rate = (right_wheel - left_wheel) / WHEEL_BASE;
+    x += speed * cosf(heading) * dt;
+    y += speed * sinf(heading) * dt;
+    heading += turn_rate * dt;
+    left_travel += left_wheel * dt;
+    right_travel += right_wheel * dt;
+
+    time_ms++;
+}
+
+
+/** @brief      Drives one lap of a track from the start line
+ */
+LapResult run_lap(const Track& track, const RobotParams& params,
+                  float time_limit, float lost_limit,
+                  const FrameSource& source)
+{
+    float x, y, heading;
+    track.pose_at(0.0f, x, y, heading);
+
+    // Start with the IR array centered over the tape
+    x -= SimRobot::SENSOR_OFFSET * cosf(heading);
+    y -= SimRobot::SENSOR_OFFSET * sinf(heading);
+    SimRobot robot(params, x, y, heading);
+    robot.set_frame_source(source);
+
+    LapResult result = {false, time_limit, 0.0f, 0.0f, 0.0f};
+    const float length = track.length();
+    float last_progress;
+    float sx, sy;
+    robot.sensor_center(sx, sy);
+    track.nearest(sx, sy, last_progress);
+
+    double error_squared = 0.0;
+    uint32_t samples = 0;
+    const uint32_t limit_ms = (uint32_t)(time_limit * 1000.0f);
+
+    while (robot.get_time_ms() < limit_ms)
+    {
+        robot.step(track);
+
+        float progress;
+        robot.sensor_center(sx, sy);
+        float error = track.nearest(sx, sy, progress);
+
+        // Unwrap the progress where the lap starts over
+        float moved = progress - last_progress;
+        if (moved > 0.5f * length)
+        {
+            moved -= length;
+        }
+        else if (moved < -0.5f * length)
+        {
+            moved += length;
+        }
+        result.distance += moved;
+        last_progress = progress;
+
+        error_squared += (double)error * error;
+        samples++;
+        if (error > result.max_error)
+        {
+            result.max_error = error;
+        }
+
+        if (error > lost_limit)
+        {
+            break;
+        }
+        if (result.distance >= length)
+        {
+            result.finished = true;
+            result.lap_time = robot.get_time_ms() / 1000.0f;
+            break;
+        }
+    }
+
+    result.rms_error = samples ? (float)sqrt(error_squared / samples) : 0.0f;
+    return result;
+}
@@ -0,0 +1,264 @@
+/** @file   track_sim.h
+ *  @brief  This file contains a simple PC model of a CleanBot following a
+ *          taped track. The model drives the same classify_frame(),
+ *          drive_speeds() and filter_speed() code as the firmware, so the
+ *          results show how the real decision logic behaves with a given set
+ *          of speeds and filter settings.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ *  @date    18 Oct 2026 IR frames can come from a stand-in for the hardware
+ *  @date    18 Oct 2026 Drive state chosen by the line tracker
+ *  @date    18 Oct 2026 Encoder counts and odometry; a route map may adjust
+ *                       the drive state and speeds
+ *  @date    18 Oct 2026 UV dose kept in a coverage grid, which may set the
+ *                       speed
+ */
+
+
+#ifndef TRACK_SIM_H
+#define TRACK_SIM_H
+
+#include <stdint.h>
+#include <functional>
+#include "drive_logic.h"
+#include "odometry.h"
+#include "route_map.h"
+#include "coverage_grid.h"
+
+/** @brief   A closed "stadium" shaped track: two straights joined by two
+ *           half circles, laid in tape on the floor.
+ *  @details The track starts at the beginning of the bottom straight and runs
+ *           counter clockwise. All lengths are in meters. The closed form
+ *           distance calculation keeps the model fast enough to run
+ *           thousands of laps.
+ */
+class Track
+{
+private:
+
+float straight;                     ///< Length of each straight
+float radius;                       ///< Radius of each half circle
+float tape_width;                   ///< Width of the tape
+
+public:
+
+/** @brief      Constructor which sets the size of the track
+ *
+ *  @param      straight_length Length of each straight
+ *  @param      curve_radius    Radius of each half circle
+ *  @param      tape            Width of the tape (3/4 inch by default)
+ */
+Track(float straight_length = 2.0f, float curve_radius = 0.5f,
+      float tape = 0.019f);
+
+/** @brief      Returns the length of one lap along the middle of the tape
+ */
+float length() const;
+
+/** @brief      Finds the point on the middle of the tape nearest a point
+ *
+ *  @param      x           Position to check
+ *  @param      y           Position to check
+ *  @param      progress    Set to the distance along the track of the
+ *                          nearest point, from 0 to length()
+ *  @return     Distance from the middle of the tape
+ */
+float nearest(float x, float y, float& progress) const;
+
+/** @brief      Returns true if a sensor at the given point is over the tape
+ */
+bool on_tape(float x, float y) const;
+
+/** @brief      Finds the position and heading at a distance along the track
+ */
+void pose_at(float progress, float& x, float& y, float& heading) const;
+
+}; //end class Track
+
+
+/** @brief   Settings for one simulated CleanBot.
+ */
+struct RobotParams
+{
+    DriveParams drive;              ///< Speeds chosen by the drive logic
+    float sim_A = DEFAULT_SIM_A;    ///< Motor filter time constant
+};
+
+/** @brief   Result of driving one lap.
+ */
+struct LapResult
+{
+    bool finished;                  ///< False if the line was lost or timed out
+    float lap_time;                 ///< Seconds to complete the lap
+    float rms_error;                ///< RMS distance of the array from the tape
+    float max_error;                ///< Largest distance of the array from the tape
+    float distance;                 ///< Meters travelled along the track
+};
+
+class SimRobot;
+
+/** @brief   Function which supplies IR frames in place of read_frame().
+ *  @details Used to put a model of the sampling hardware, such as the DMA
+ *           capture stand-in, between the track and the drive logic.
+ */
+typedef std::function<uint8_t (const SimRobot& robot, const Track& track)>
+    FrameSource;
+
+/** @brief   Class which models one CleanBot driving on a track.
+ *  @details The model runs in 1 ms steps. Every 5 ms the IR array is read and
+ *           the drive state and wheel speeds chosen as in @c task_IR_array
+ *           and @c task_drive_train; every 50 ms the motor filter takes a
+ *           step as in @c Motor_Driver::ChangeSpeed(). The motors themselves
+ *           are modelled as a first-order lag. Every 10 ms the lamp exposes
+ *           the coverage grid, if there is one, as in @c led_task.
+ */
+class SimRobot
+{
+private:
+
+RobotParams params;                 ///< Speeds and filter settings
+float x;                            ///< Position of the middle of the axle
+float y;                            ///< Position of the middle of the axle
+float heading;                      ///< Direction of travel in radians
+float left_wheel;                   ///< Left wheel speed in m/s
+float right_wheel;                  ///< Right wheel speed in m/s
+float left_filtered;                ///< Output of the left motor filter
+float right_filtered;               ///< Output of the right motor filter
+int16_t left_target;                ///< Speed asked for by the drive logic
+int16_t right_target;               ///< Speed asked for by the drive logic
+LineTracker tracker;                ///< Drive state from track_line()
+LineFeatures features;              ///< Shape of the line in last_frame
+uint8_t last_frame;                 ///< Most recent IR frame
+uint32_t time_ms;                   ///< Time since the robot was placed
+FrameSource frame_source;           ///< Where frames come from, if not ideal
+double left_travel;                 ///< Meters the left wheel has rolled
+double right_travel;                ///< Meters the right wheel has rolled
+OdometryParams odometry_params;     ///< Size of the wheels and encoders
+Odometry odometry;                  ///< Dead reckoning from encoder counts
+RouteMap* p_route;                  ///< Route map to consult, if any
+CoverageGrid* p_coverage;           ///< Grid the lamp exposes, if any
+bool dose_speed;                    ///< True if the grid sets the speed
+
+public:
+
+/// Distance from the axle to the IR array, in meters
+static const float SENSOR_OFFSET;
+
+/// Distance between neighbouring sensors on the QTR-8RC, in meters
+static const float SENSOR_PITCH;
+
+/// Distance between the wheels, in meters
+static const float WHEEL_BASE;
+
+/// Wheel speed in m/s at full power
+static const float TOP_SPEED;
+
+/// Time constant of the motors themselves, in seconds
+static const float MOTOR_TAU;
+
+/** @brief      Constructor which places the robot on the track
+ *
+ *  @param      robot_params    Speeds and filter settings to use
+ *  @param      start_x         Position of the middle of the axle
+ *  @param      start_y         Position of the middle of the axle
+ *  @param      start_heading   Direction of travel in radians
+ */
+SimRobot(const RobotParams& robot_params, float start_x, float start_y,
+         float start_heading);
+
+/** @brief      Reads the simulated IR array
+ *  @return     Frame in the same format as IR_Array::getFrame()
+ */
+uint8_t read_frame(const Track& track) const;
+
+/** @brief      Reads the IR array of a robot at any pose
+ *  @details    Used to see what the array read part way between two steps.
+ *
+ *  @param      track       Track to read
+ *  @param      axle_x      Position of the middle of the axle
+ *  @param      axle_y      Position of the middle of the axle
+ *  @param      axle_heading Direction of travel in radians
+ *  @return     Frame in the same format as IR_Array::getFrame()
+ */
+static uint8_t frame_at(const Track& track, float axle_x, float axle_y,
+                        float axle_heading);
+
+/** @brief      Makes the robot take its IR frames from a function
+ *  @details    Without a frame source, the ideal frame from read_frame() is
+ *              used.
+ */
+void set_frame_source(const FrameSource& source) { frame_source = source; }
+
+/** @brief      Makes the robot learn and use a route map
+ *  @details    Each IR frame, the map is given the odometry and the kind of
+ *              line, and its advice goes through route_drive() as in
+ *              @c task_IR_array. Without a map, the robot is purely reactive.
+ */
+void set_route_map(RouteMap* p_map) { p_route = p_map; }
+
+/** @brief      Makes the robot's lamp expose a coverage grid
+ *  @details    The lamp is lit while the robot is enabled. If
+ *              @p set_speed is true, the grid's speed limit goes into the
+ *              route advice as in @c task_IR_array; otherwise the grid only
+ *              records the dose.
+ *
+ *  @param      p_grid      Grid to expose, or NULL for none
+ *  @param      set_speed   True to let the grid slow the robot down
+ */
+void set_coverage_grid(CoverageGrid* p_grid, bool set_speed)
+{
+    p_coverage = p_grid;
+    dose_speed = set_speed;
+}
+
+/** @brief      Moves the model forward by 1 ms
+ *
+ *  @param      track   Track the robot is following
+ *  @param      enabled True if the WiFi signal says the robot may run
+ */
+void step(const Track& track, bool enabled = true);
+
+/** @brief      Finds the middle of the IR array
+ */
+void sensor_center(float& sx, float& sy) const;
+
+float get_x() const { return x; }
+float get_y() const { return y; }
+float get_heading() const { return heading; }
+uint32_t get_time_ms() const { return time_ms; }
+uint8_t get_frame() const { return last_frame; }
+uint8_t get_drive_state() const { return tracker.drive_state; }
+const LineFeatures& get_features() const { return features; }
+float get_left_wheel() const { return left_wheel; }
+float get_right_wheel() const { return right_wheel; }
+const Odometry& get_odometry() const { return odometry; }
+
+/** @brief      Returns the left encoder count, as the firmware would read it
+ */
+int32_t get_left_count() const;
+
+/** @brief      Returns the right encoder count, as the firmware would read it
+ */
+int32_t get_right_count() const;
+
+}; //end class SimRobot
+
+
+/** @brief      Drives one lap of a track from the start line
+ *
+ *  @param      track       Track to drive on
+ *  @param      params      Speeds and filter settings to use
+ *  @param      time_limit  Seconds to allow before giving up
+ *  @param      lost_limit  Distance from the tape at which the line is lost
+ *  @param      source      Where IR frames come from; ideal frames if empty
+ *  @return     Lap time and how well the robot followed the tape
+ */
+LapResult run_lap(const Track& track, const RobotParams& params,
+                  float time_limit = 60.0f, float lost_limit = 0.15f,
+                  const FrameSource& source = FrameSource());
+
+#endif //end if: define track simulation declarations
@@ -0,0 +1,285 @@
+/** @file sweep.cpp
+ *      This file contains a PC program which tunes the CleanBot's speeds and
+ *      motor filter by simulating many robots on a model of the track. Every
+ *      combination on a grid of settings drives one lap, the laps are shared
+ *      out over all cores by a work stealing pool, and then a pattern search
+ *      refines the best setting found. The results are written to a CSV file
+ *      ranked by a score which combines lap time and tracking error. Build it
+ *      with <tt>pio run -e sweep</tt>.
+ *
+ *      Usage: <tt>sweep [--threads N] [--out file.csv] [--straight m]
+ *             [--radius m] [--error-weight s_per_m]</tt>
+ *
+ *  @author  WC Montgomery, A Recidoro, A Haduong
+ *
+ *  @date    18 Oct 2026    Original file
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <vector>
+#include "drive_logic.h"
+#include "host/common/work_pool.h"
+#include "host/sim/track_sim.h"
+
+
+/** @brief   One setting which has been tried and how it did.
+ */
+struct Trial
+{
+    RobotParams params;             ///< The setting
+    LapResult result;               ///< How the lap went
+    float score;                    ///< Lower is better
+};
+
+/// Seconds of lap time which are worth one meter of RMS tracking error
+static float error_weight = 200.0f;
+
+/** @brief   Scores a lap; finished laps always beat unfinished ones.
+ */
+static float score_lap (const LapResult& result)
+{
+    if (result.finished)
+    {
+        return result.lap_time + error_weight * result.rms_error;
+    }
+    // Rank lost laps by how far they got
+    return 1.0e6f - result.distance;
+}
+
+/** @brief   Drives one lap for every setting in a list, in parallel.
+ */
+static void run_trials (WorkPool& pool, const Track& track,
+                        std::vector<Trial>& trials)
+{
+    std::vector<WorkPool::Job> jobs;
+    for (Trial& trial : trials)
+    {
+        Trial* p_trial = &trial;
+        jobs.push_back ([p_trial, &track] (size_t)
+        {
+            p_trial->result = run_lap (track, p_trial->params);
+            p_trial->score = score_lap (p_trial->result);
+        });
+    }
+    pool.run (jobs);
+}
+
+/** @brief   Keeps a percentage between 0 and 100.
+ */
+static uint8_t clamp_percent (int value)
+{
+    return (uint8_t)std::min (100, std::max (0, value));
+}
+
+/** @brief   Makes the settings next to one setting for the pattern search.
+ *  @param   center The setting to search around
+ *  @param   step Size of the change in percent and speed units
+ *  @param   a_step Size of the change in the filter time constant
+ */
+static std::vector<Trial> neighbours (const RobotParams& center, int step,
+                                      float a_step)
+{
+    std::vector<Trial> trials;
+    for (int axis = 0; axis < 5; axis++)
+    {
+        for (int sign = -1; sign <= 1; sign += 2)
+        {
+            RobotParams params = center;
+            int delta = sign * step;
+            switch (axis)
+            {
+                case 0:
+                    params.drive.max_speed = (uint8_t)std::min (255,
+                        std::max (1, params.drive.max_speed + delta));
+                    break;
+                case 1:
+                    params.drive.cruise_percent = clamp_percent (
+                        params.drive.cruise_percent + delta);
+                    break;
+                case 2:
+                    params.drive.turn_percent = clamp_percent (
+                        params.drive.turn_percent + delta);
+                    break;
+                case 3:
+                    params.drive.spin_percent = clamp_percent (
+                        params.drive.spin_percent + delta);
+                    break;
+                default:
+                    params.sim_A = std::min (0.99f,
+                        std::max (0.0f, params.sim_A + sign * a_step));
+                    break;
+            }
+            trials.push_back ({params, LapResult (), 0.0f});
+        }
+    }
+    return trials;
+}
+
+
+/** @brief   Runs the grid search and pattern search and writes the report.
+ */
+int main (int argc, char** argv)
+{
+    size_t threads = 0;
+    const char* out_name = "sweep_report.csv";
+    float straight = 2.0f;
+    float radius = 0.5f;
+
+    for (int arg = 1; arg + 1 < argc; arg += 2)
+    {
+        if (strcmp (argv[arg], "--threads") == 0)
+        {
+            threads = (size_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--out") == 0)
+        {
+            out_name = argv[arg + 1];
+        }
+        else if (strcmp (argv[arg], "--straight") == 0)
+        {
+            straight = (float)atof (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--radius") == 0)
+        {
+            radius = (float)atof (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--error-weight") == 0)
+        {
+            error_weight = (float)atof (argv[arg + 1]);
+        }
+        else
+        {
+            fprintf (stderr, "Unknown option %s\n", argv[arg]);
+            return 2;
+        }
+    }
+
+    Track track (straight, radius);
+    WorkPool pool (threads);
+    auto begin = std::chrono::steady_clock::now ();
+
+    // The grid, which brackets the hand tuned defaults
+    const uint8_t speeds[] = {135, 165, 195, 225, 255};
+    const uint8_t cruises[] = {30, 45, 60, 75, 90};
+    const uint8_t turns[] = {0, 15, 30, 45, 60};
+    const uint8_t spins[] = {25, 50, 75};
+    const float filters[] = {0.0f, 0.5f, 0.8f, 0.9f};
+
+    std::vector<Trial> trials;
+    for (uint8_t speed : speeds)
+        for (uint8_t cruise : cruises)
+            for (uint8_t turn : turns)
+                for (uint8_t spin : spins)
+                    for (float filter : filters)
+                    {
+                        RobotParams params;
+                        params.drive.max_speed = speed;
+                        params.drive.cruise_percent = cruise;
+                        params.drive.turn_percent = turn;
+                        params.drive.spin_percent = spin;
+                        params.sim_A = filter;
+                        trials.push_back ({params, LapResult (), 0.0f});
+                    }
+
+    // The untouched firmware settings, for comparison
+    trials.push_back ({RobotParams (), LapResult (), 0.0f});
+
+    run_trials (pool, track, trials);
+    size_t laps = trials.size ();
+
+    // Pattern search: try a step either way along every axis from the best
+    // setting, move if that helps, and otherwise shrink the steps
+    Trial best = *std::min_element (trials.begin (), trials.end (),
+        [] (const Trial& a, const Trial& b) { return a.score < b.score; });
+    int step = 8;
+    float a_step = 0.04f;
+    while (step >= 1)
+    {
+        std::vector<Trial> nearby = neighbours (best.params, step, a_step);
+        run_trials (pool, track, nearby);
+        laps += nearby.size ();
+
+        bool moved = false;
+        for (const Trial& trial : nearby)
+        {
+            if (trial.score < best.score)
+            {
+                best = trial;
+                moved = true;
+            }
+            trials.push_back (trial);
+        }
+        if (!moved)
+        {
+            step /= 2;
+            a_step /= 2.0f;
+        }
+    }
+
+    double seconds = std::chrono::duration<double> (
+        std::chrono::steady_clock::now () - begin).count ();
+
+    // The pattern search visits some settings more than once; report each once
+    std::set<uint64_t> seen;
+    std::vector<Trial> unique;
+    for (const Trial& trial : trials)
+    {
+        uint64_t key = (uint64_t)trial.params.drive.max_speed << 48
+            | (uint64_t)trial.params.drive.cruise_percent << 40
+            | (uint64_t)trial.params.drive.turn_percent << 32
+            | (uint64_t)trial.params.drive.spin_percent << 24
+            | (uint64_t)(trial.params.sim_A * 10000.0f + 0.5f);
+        if (seen.insert (key).second)
+        {
+            unique.push_back (trial);
+        }
+    }
+    trials.swap (unique);
+
+    std::stable_sort (trials.begin (), trials.end (),
+        [] (const Trial& a, const Trial& b) { return a.score < b.score; });
+
+    FILE* p_out = fopen (out_name, "w");
+    if (p_out == NULL)
+    {
+        fprintf (stderr, "Can't write %s\n", out_name);
+        return 1;
+    }
+    fprintf (p_out, "rank,max_speed,cruise_percent,turn_percent,spin_percent,"
+             "sim_A,finished,lap_time_s,rms_error_mm,max_error_mm,"
+             "distance_m,score\n");
+    for (size_t rank = 0; rank < trials.size (); rank++)
+    {
+        const Trial& trial = trials[rank];
+        fprintf (p_out, "%zu,%u,%u,%u,%u,%.3f,%d,%.3f,%.2f,%.2f,%.3f,%.3f\n",
+                 rank + 1, trial.params.drive.max_speed,
+                 trial.params.drive.cruise_percent,
+                 trial.params.drive.turn_percent,
+                 trial.params.drive.spin_percent, trial.params.sim_A,
+                 trial.result.finished ? 1 : 0, trial.result.lap_time,
+                 trial.result.rms_error * 1000.0f,
+                 trial.result.max_error * 1000.0f, trial.result.distance,
+                 trial.score);
+    }
+    fclose (p_out);
+
+    printf ("%zu laps on %zu threads in %.2f s (%.0f laps/s), report in %s\n",
+            laps, pool.size (), seconds, laps / seconds, out_name);
+    printf ("rank speed cruise turn spin  sim_A  lap_s  rms_mm\n");
+    for (size_t rank = 0; rank < trials.size () && rank < 10; rank++)
+    {
+        const Trial& trial = trials[rank];
+        printf ("%4zu %5u %6u %4u %4u  %5.3f  %5.2f  %6.2f\n", rank + 1,
+                trial.params.drive.max_speed, trial.params.drive.cruise_percent,
+                trial.params.drive.turn_percent, trial.params.drive.spin_percent,
+                trial.params.sim_A, trial.result.lap_time,
+                trial.result.rms_error * 1000.0f);
+    }
+    return 0;
+}
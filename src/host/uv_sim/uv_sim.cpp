@@ -0,0 +1,210 @@
+/** @file uv_sim.cpp
+ *      This file contains a PC program which checks the coverage grid before
+ *      it goes on the robot. A simulated CleanBot drives laps of a taped
+ *      track with its lamp lit until the floor it has driven over has had
+ *      the required UV dose. This is done once at the usual speeds, with
+ *      the grid only recording the dose, and once with the grid setting the
+ *      speed. Every 10 simulated seconds the coverage and the grid's
+ *      estimate of the time left are printed, then the time each session
+ *      took to reach the target coverage and how much dose went to cells
+ *      which already had enough. Build it with <tt>pio run -e uv_sim</tt>.
+ *
+ *      Usage: <tt>uv_sim [--dose counts] [--target %] [--cruise %]
+ *             [--filter sim_A] [--minutes N]</tt>
+ *
+ *  @author  WC Montgomery, A Recidoro, A Haduong
+ *
+ *  @date    18 Oct 2026    Original file
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "drive_logic.h"
+#include "coverage_grid.h"
+#include "host/sim/track_sim.h"
+
+/// Distance from the tape at which the line counts as lost, in meters
+static const float LOST_LIMIT = 0.15f;
+
+/// Simulated milliseconds between progress lines
+static const uint32_t REPORT_MS = 10000;
+
+/** @brief   How one session went.
+ */
+struct SessionResult
+{
+    bool lost;                      ///< True if the robot left the line
+    float done_time;                ///< Seconds to the target, or 0
+    uint16_t touched;               ///< Cells which had any dose
+    float mean_dose;                ///< Average counts per touched cell
+};
+
+/** @brief   Adds up the dose of every cell of a grid.
+ */
+static uint32_t total_dose (const CoverageGrid& grid,
+                            const CoverageParams& params)
+{
+    uint32_t total = 0;
+    for (uint16_t row = 0; row < COVERAGE_ROWS; row++)
+    {
+        for (uint16_t column = 0; column < COVERAGE_COLUMNS; column++)
+        {
+            total += grid.dose_at (
+                params.origin_x_mm + (column + 0.5f) * COVERAGE_CELL_MM,
+                params.origin_y_mm + (row + 0.5f) * COVERAGE_CELL_MM);
+        }
+    }
+    return total;
+}
+
+/** @brief   Drives laps with the lamp lit until the floor is done.
+ *
+ *  @param   track       Track to drive
+ *  @param   params      Speeds and filter settings to use
+ *  @param   coverage    Size of the lamp and the dose needed
+ *  @param   set_speed   True to let the grid set the speed
+ *  @param   target      Coverage percentage at which the floor is done
+ *  @param   limit_ms    Simulated time to give up after
+ *  @return  Time to reach the target coverage and the dose used
+ */
+static SessionResult run_session (const Track& track,
+                                  const RobotParams& params,
+                                  const CoverageParams& coverage,
+                                  bool set_speed, uint8_t target,
+                                  uint32_t limit_ms)
+{
+    float x, y, heading;
+    track.pose_at (0.0f, x, y, heading);
+    x -= SimRobot::SENSOR_OFFSET * cosf (heading);
+    y -= SimRobot::SENSOR_OFFSET * sinf (heading);
+    SimRobot robot (params, x, y, heading);
+
+    // The grid is 4 KB, so it isn't put on the stack
+    static CoverageGrid grid;
+    grid = CoverageGrid (coverage);
+    robot.set_coverage_grid (&grid, set_speed);
+
+    SessionResult result = {};
+    printf ("   time_s  coverage  cells  estimate_s\n");
+    while (robot.get_time_ms () < limit_ms)
+    {
+        robot.step (track);
+
+        float sx, sy, progress;
+        robot.sensor_center (sx, sy);
+        if (track.nearest (sx, sy, progress) > LOST_LIMIT)
+        {
+            printf ("   line lost at %.1f s\n",
+                    robot.get_time_ms () / 1000.0f);
+            result.lost = true;
+            break;
+        }
+
+        float seconds = robot.get_time_ms () / 1000.0f;
+        uint8_t coverage_now = grid.coverage_percent ();
+        if (coverage_now >= target)
+        {
+            result.done_time = seconds;
+            break;
+        }
+        if (robot.get_time_ms () % REPORT_MS == 0)
+        {
+            uint32_t left_ms = grid.completion_ms ();
+            printf ("   %6.0f  %7u%%  %5u  %10.0f\n", seconds, coverage_now,
+                    grid.get_touched (),
+                    left_ms == UINT32_MAX ? -1.0f : left_ms / 1000.0f);
+        }
+    }
+
+    result.touched = grid.get_touched ();
+    result.mean_dose = result.touched
+        ? (float)total_dose (grid, coverage) / result.touched : 0.0f;
+    return result;
+}
+
+/** @brief   Prints the totals for one session.
+ */
+static void print_result (const SessionResult& result, uint8_t target,
+                          uint8_t required)
+{
+    if (result.done_time > 0.0f)
+    {
+        printf ("%u%% coverage at %.1f s", target, result.done_time);
+    }
+    else
+    {
+        printf ("%u%% coverage not reached", target);
+    }
+    printf ("; %u cells, mean dose %.1f of %u needed\n\n", result.touched,
+            result.mean_dose, required);
+}
+
+
+/** @brief   Runs both sessions and prints how they went.
+ */
+int main (int argc, char** argv)
+{
+    uint32_t minutes = 15;
+    uint8_t target = 95;
+    RobotParams params;
+    params.drive.max_speed = 255;
+    params.drive.cruise_percent = 90;
+    params.drive.turn_percent = 15;
+    params.drive.spin_percent = 50;
+    params.sim_A = 0.5f;
+
+    // Start near the bottom left corner of the grid, with the whole track
+    // on it
+    CoverageParams coverage;
+    coverage.origin_x_mm = -800;
+    coverage.origin_y_mm = -800;
+
+    for (int arg = 1; arg + 1 < argc; arg += 2)
+    {
+        if (strcmp (argv[arg], "--dose") == 0)
+        {
+            coverage.required_dose = (uint8_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--target") == 0)
+        {
+            target = (uint8_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--cruise") == 0)
+        {
+            params.drive.cruise_percent = (uint8_t)atoi (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--filter") == 0)
+        {
+            params.sim_A = (float)atof (argv[arg + 1]);
+        }
+        else if (strcmp (argv[arg], "--minutes") == 0)
+        {
+            minutes = (uint32_t)atoi (argv[arg + 1]);
+        }
+        else
+        {
+            fprintf (stderr, "Unknown option %s\n", argv[arg]);
+            return 2;
+        }
+    }
+
+    Track track (1.5f, 0.5f);
+    const uint32_t limit_ms = minutes * 60000;
+    printf ("Track %.2f m; dose %u counts of %u ms; lamp %u x %u mm\n\n",
+            track.length (), coverage.required_dose, COVERAGE_DOSE_MS,
+            coverage.lamp_width_mm, coverage.lamp_length_mm);
+
+    printf ("Usual speeds\n");
+    SessionResult usual = run_session (track, params, coverage, false,
+                                       target, limit_ms);
+    print_result (usual, target, coverage.required_dose);
+
+    printf ("Speed set by the dose\n");
+    SessionResult dosed = run_session (track, params, coverage, true,
+                                       target, limit_ms);
+    print_result (dosed, target, coverage.required_dose);
+    return 0;
+}
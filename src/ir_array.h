@@ -11,6 +11,7 @@
  *  
  *  @date    12 Nov 2020 File Created
  *  @date    13 Nov 2020 Class Structure, variables, and methods created
+ *  @date    18 Oct 2026 Added getFrame() to read all sensors in one pass
  */
 
 
@@ -81,6 +82,11 @@ bool getSensor_7();
  */
 bool getSensor_8();
 
+/** @brief      Reads all 8 sensors in one pass and packs them into a bitmask
+ *  @details    Bit 0 holds sensor 1 (passenger side) and bit 7 holds sensor 8
+ *              (driver side). A set bit means that sensor sees the line.
+ */
+uint8_t getFrame();
 
 }; //end class decleration
 
@@ -11,6 +11,7 @@
  * 
  *  @date   12 Nov 2020     File Created
  *  @date   13 Nov 2020     Constructor defined
+ *  @date   18 Oct 2026     getFrame() added
  */
 
 #include "ir_array.h"
@@ -96,3 +97,21 @@ bool IR_Array::getSensor_8(){
     return digitalRead(sensorPin_8);
 }
 
+/** @brief      Reads all 8 sensors in one pass and packs them into a bitmask
+ *  @details    Bit 0 holds sensor 1 (passenger side) and bit 7 holds sensor 8
+ *              (driver side). Each sensor is read exactly once, so the frame
+ *              is a consistent snapshot rather than a series of reads spread
+ *              over the decision logic.
+ */
+uint8_t IR_Array::getFrame(){
+    uint8_t frame = 0;
+    frame |= (uint8_t)(digitalRead(sensorPin_1) ? 1 : 0) << 0;
+    frame |= (uint8_t)(digitalRead(sensorPin_2) ? 1 : 0) << 1;
+    frame |= (uint8_t)(digitalRead(sensorPin_3) ? 1 : 0) << 2;
+    frame |= (uint8_t)(digitalRead(sensorPin_4) ? 1 : 0) << 3;
+    frame |= (uint8_t)(digitalRead(sensorPin_5) ? 1 : 0) << 4;
+    frame |= (uint8_t)(digitalRead(sensorPin_6) ? 1 : 0) << 5;
+    frame |= (uint8_t)(digitalRead(sensorPin_7) ? 1 : 0) << 6;
+    frame |= (uint8_t)(digitalRead(sensorPin_8) ? 1 : 0) << 7;
+    return frame;
+}
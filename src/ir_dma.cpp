@@ -0,0 +1,239 @@
+/** @file   ir_dma.cpp
+ *  @brief  This file contains the definition of the IR array DMA capture
+ *          unit for the STM32L4. It is only compiled into builds which
+ *          define @c CLEANBOT_IR_DMA, so other builds keep DMA1 channel 3's
+ *          interrupt handler free.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ */
+
+#if defined (STM32L4xx) && defined (CLEANBOT_IR_DMA)
+
+#include <PrintStream.h>
+#include "ir_dma.h"
+
+/// The capture unit which is running, for the interrupt handler
+static IR_DMA_Capture* p_active = NULL;
+
+
+/** @brief      Constructor which saves the pins and the sample rate
+ *  @details    The sample rate is kept between 2 and 10 kHz, and lowered if
+ *              a frame would need more samples than the buffer holds.
+ *
+ *  @param      pins            Array of the 8 Arduino pins of the sensors
+ *  @param      frame_ms        Milliseconds per frame, normally 5
+ *  @param      samples_per_sec Sample rate, from 2000 to 10000 per second
+ */
+IR_DMA_Capture::IR_DMA_Capture(uint8_t pins[], uint8_t frame_ms,
+                               uint32_t samples_per_sec)
+    : task(NULL), ready_half(0), overruns(0)
+{
+    for (uint8_t sensor = 0; sensor < 8; sensor++)
+    {
+        sensorPins[sensor] = pins[sensor];
+    }
+
+    sample_hz = samples_per_sec;
+    if (sample_hz < 2000)
+    {
+        sample_hz = 2000;
+    }
+    else if (sample_hz > 10000)
+    {
+        sample_hz = 10000;
+    }
+    uint32_t samples = sample_hz * frame_ms / 1000;
+    if (samples > IR_DMA_MAX_SAMPLES)
+    {
+        samples = IR_DMA_MAX_SAMPLES;
+        sample_hz = samples * 1000 / frame_ms;
+    }
+    samples_per_frame = samples > 0 ? samples : 1;
+}
+
+/** @brief      Starts the timers and DMA
+ *  @return     False if the sensors are on more than two ports
+ */
+bool IR_DMA_Capture::begin()
+{
+    // Find which port and bit each sensor is on
+    ports[0] = NULL;
+    ports[1] = NULL;
+    for (uint8_t sensor = 0; sensor < 8; sensor++)
+    {
+        pinMode(sensorPins[sensor], INPUT);
+        PinName pin_name = digitalPinToPinName(sensorPins[sensor]);
+        GPIO_TypeDef* port = get_GPIO_Port(STM_PORT(pin_name));
+
+        uint8_t index;
+        if (ports[0] == NULL || ports[0] == port)
+        {
+            index = 0;
+        }
+        else if (ports[1] == NULL || ports[1] == port)
+        {
+            index = 1;
+        }
+        else
+        {
+            return false;
+        }
+        ports[index] = port;
+        map.port[sensor] = index;
+        map.bit[sensor] = STM_PIN(pin_name);
+    }
+    if (ports[1] == NULL)
+    {
+        // All sensors are on one port; the second channel just reads it too
+        ports[1] = ports[0];
+    }
+
+    task = xTaskGetCurrentTaskHandle();
+    p_active = this;
+
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_RCC_TIM6_CLK_ENABLE();
+    __HAL_RCC_TIM7_CLK_ENABLE();
+
+    // DMA1 channel 3 copies the first port's IDR on each TIM6 update
+    dma_0.Instance = DMA1_Channel3;
+    dma_0.Init.Request = DMA_REQUEST_6;
+    dma_0.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    dma_0.Init.PeriphInc = DMA_PINC_DISABLE;
+    dma_0.Init.MemInc = DMA_MINC_ENABLE;
+    dma_0.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    dma_0.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    dma_0.Init.Mode = DMA_CIRCULAR;
+    dma_0.Init.Priority = DMA_PRIORITY_HIGH;
+
+    // DMA1 channel 4 copies the second port's IDR on each TIM7 update
+    dma_1 = dma_0;
+    dma_1.Instance = DMA1_Channel4;
+    dma_1.Init.Request = DMA_REQUEST_5;
+
+    if (HAL_DMA_Init(&dma_0) != HAL_OK || HAL_DMA_Init(&dma_1) != HAL_OK)
+    {
+        return false;
+    }
+
+    // Only the first channel interrupts; both are filled in step, since
+    // their timers run at the same rate and are started together
+    dma_0.XferHalfCpltCallback = half_complete;
+    dma_0.XferCpltCallback = full_complete;
+    HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+
+    uint16_t length = 2 * samples_per_frame;
+    HAL_DMA_Start(&dma_1, (uint32_t)&ports[1]->IDR, (uint32_t)samples_1,
+                  length);
+    HAL_DMA_Start_IT(&dma_0, (uint32_t)&ports[0]->IDR, (uint32_t)samples_0,
+                     length);
+
+    // TIM6 and TIM7 run from the APB1 timer clock, which is twice PCLK1
+    // whenever the APB1 prescaler isn't 1
+    uint32_t timer_clock = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+    {
+        timer_clock *= 2;
+    }
+    uint32_t reload = timer_clock / sample_hz - 1;
+
+    TIM_TypeDef* timers[2] = {TIM7, TIM6};
+    for (TIM_TypeDef* timer : timers)
+    {
+        timer->CR1 = 0;
+        timer->PSC = 0;
+        timer->ARR = reload;
+        timer->EGR = TIM_EGR_UG;        // load PSC before DMA requests are on
+        timer->SR = 0;
+        timer->DIER = TIM_DIER_UDE;
+    }
+
+    // Start TIM7 first so the second port is never behind the first one
+    TIM7->CR1 = TIM_CR1_CEN;
+    TIM6->CR1 = TIM_CR1_CEN;
+
+    return true;
+}
+
+/** @brief      Waits for the next frame and filters it by majority vote
+ *  @details    Each notification from the interrupt means one half of the
+ *              buffer has been filled. If more than one has piled up, the
+ *              older halves have been overwritten and are counted as overruns.
+ */
+bool IR_DMA_Capture::getFrame(uint8_t& frame, TickType_t timeout)
+{
+    uint32_t halves = ulTaskNotifyTake(pdTRUE, timeout);
+    if (halves == 0)
+    {
+        return false;
+    }
+    overruns += halves - 1;
+
+    uint16_t offset = ready_half * samples_per_frame;
+    frame = majority_frame(map, samples_0 + offset, samples_1 + offset,
+                           samples_per_frame);
+    return true;
+}
+
+/** @brief      Prints the sample rate and the number of overruns
+ *  @details    An overrun means the IR array task didn't get to a frame
+ *              before the DMA wrote over it, so the frame was never used.
+ */
+void IR_DMA_Capture::print(Print& printer) const
+{
+    printer.printf("IR DMA: %lu Hz, %u samples per frame, %lu overruns",
+                   (unsigned long)sample_hz, (unsigned)samples_per_frame,
+                   (unsigned long)overruns);
+    printer << endl;
+}
+
+/** @brief      Tells the reading task that a half of the buffer is ready
+ */
+void IR_DMA_Capture::wake_task(uint8_t half)
+{
+    ready_half = half;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+/** @brief      DMA callback for the first half of the buffer being filled
+ */
+void IR_DMA_Capture::half_complete(DMA_HandleTypeDef* p_dma)
+{
+    (void) p_dma;
+    p_active->wake_task(0);
+}
+
+/** @brief      DMA callback for the second half of the buffer being filled
+ */
+void IR_DMA_Capture::full_complete(DMA_HandleTypeDef* p_dma)
+{
+    (void) p_dma;
+    p_active->wake_task(1);
+}
+
+/** @brief      Called by the DMA interrupt handler
+ */
+void IR_DMA_Capture::handle_interrupt()
+{
+    HAL_DMA_IRQHandler(&dma_0);
+}
+
+/** @brief      Interrupt handler for DMA1 channel 3, which raises the half
+ *              and full transfer interrupts for the IR capture
+ */
+extern "C" void DMA1_Channel3_IRQHandler(void)
+{
+    if (p_active != NULL)
+    {
+        p_active->handle_interrupt();
+    }
+}
+
+#endif // STM32L4xx && CLEANBOT_IR_DMA
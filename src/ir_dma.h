@@ -0,0 +1,107 @@
+/** @file   ir_dma.h
+ *  @brief  This file contains a capture unit which samples the IR array with
+ *          DMA. A hardware timer triggers DMA transfers of the GPIO input
+ *          data registers into a circular buffer, so no processor time is
+ *          spent taking each sample. The IR task wakes once per half buffer
+ *          and filters all the samples in that half into one frame.
+ *  @details On the Nucleo-L476RG the 8 sensors are on two ports (PA5-PA10
+ *           and PB5-PB6), so each port has its own DMA channel. TIM6 drives
+ *           DMA1 channel 3 for the first port and TIM7 drives DMA1 channel 4
+ *           for the second; both run at the same rate. TIM6 and TIM7 are the
+ *           basic timers, which aren't used for PWM, but they are the default
+ *           timers for @c tone() and the Servo library, so those can't be
+ *           used at the same time.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ */
+
+
+#ifndef IR_DMA_H
+#define IR_DMA_H
+
+#include <Arduino.h>
+#include <STM32FreeRTOS.h>
+#include "ir_frames.h"
+
+/// Default sample rate for builds which capture the IR array with DMA
+#ifndef IR_DMA_SAMPLE_HZ
+    #define IR_DMA_SAMPLE_HZ 5000
+#endif
+
+/// Most samples that can be taken for one frame (10 kHz, 5 ms frames)
+const uint16_t IR_DMA_MAX_SAMPLES = 50;
+
+/** @brief   Class which captures the IR array's pins using a timer and DMA.
+ *  @details Only one capture unit can run at a time, because it owns TIM6,
+ *           TIM7 and two DMA channels.
+ */
+class IR_DMA_Capture
+{
+private:
+
+IrPinMap map;                       ///< Where each sensor is in the ports
+uint8_t sensorPins[8];              ///< Arduino pin numbers of the sensors
+uint32_t sample_hz;                 ///< Samples per second
+uint16_t samples_per_frame;         ///< Samples in each half of the buffer
+GPIO_TypeDef* ports[2];             ///< The GPIO ports the sensors are on
+
+/// Circular buffers the DMA fills, two frames long
+uint16_t samples_0[2 * IR_DMA_MAX_SAMPLES];
+uint16_t samples_1[2 * IR_DMA_MAX_SAMPLES];
+
+DMA_HandleTypeDef dma_0;            ///< DMA channel for the first port
+DMA_HandleTypeDef dma_1;            ///< DMA channel for the second port
+TaskHandle_t task;                  ///< Task to wake when a half is ready
+volatile uint8_t ready_half;        ///< Half of the buffer last filled
+uint32_t overruns;                  ///< Frames the task was too slow for
+
+static void half_complete(DMA_HandleTypeDef* p_dma);
+static void full_complete(DMA_HandleTypeDef* p_dma);
+void wake_task(uint8_t half);
+
+public:
+
+/** @brief      Constructor which saves the pins and the sample rate
+ *
+ *  @param      pins            Array of the 8 Arduino pins of the sensors
+ *  @param      frame_ms        Milliseconds per frame, normally 5
+ *  @param      samples_per_sec Sample rate, from 2000 to 10000 per second
+ */
+IR_DMA_Capture(uint8_t pins[], uint8_t frame_ms = 5,
+               uint32_t samples_per_sec = 5000);
+
+/** @brief      Starts the timers and DMA
+ *  @details    Must be called from the task which will read the frames,
+ *              because that task is the one woken when a frame is ready.
+ *  @return     False if the sensors are on more than two ports
+ */
+bool begin();
+
+/** @brief      Waits for the next frame and filters it by majority vote
+ *
+ *  @param      frame   Set to the filtered frame
+ *  @param      timeout RTOS ticks to wait for a frame
+ *  @return     False if no frame arrived in time
+ */
+bool getFrame(uint8_t& frame, TickType_t timeout);
+
+/** @brief      Returns the number of frames which were overwritten before
+ *              the task could read them
+ */
+uint32_t getOverruns() const { return overruns; }
+
+/** @brief      Prints the sample rate and the number of overruns
+ */
+void print(Print& printer) const;
+
+/** @brief      Called by the DMA interrupt handler
+ */
+void handle_interrupt();
+
+}; //end class IR_DMA_Capture
+
+#endif //end if: define IR DMA capture declaration
@@ -0,0 +1,71 @@
+/** @file   ir_frames.cpp
+ *  @brief  This file contains the definitions of the functions which turn
+ *          GPIO port samples into IR frames.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ */
+
+#include "ir_frames.h"
+
+/** @brief      Builds an IR frame from one sample of both ports
+ */
+uint8_t pack_ir_sample(const IrPinMap& map, uint16_t port_0, uint16_t port_1)
+{
+    uint8_t frame = 0;
+    for (uint8_t sensor = 0; sensor < 8; sensor++)
+    {
+        uint16_t port = map.port[sensor] ? port_1 : port_0;
+        frame |= ((port >> map.bit[sensor]) & 1) << sensor;
+    }
+    return frame;
+}
+
+/** @brief      Builds the port samples which would give an IR frame
+ */
+void unpack_ir_sample(const IrPinMap& map, uint8_t frame,
+                      uint16_t& port_0, uint16_t& port_1)
+{
+    port_0 = 0;
+    port_1 = 0;
+    for (uint8_t sensor = 0; sensor < 8; sensor++)
+    {
+        if (frame & (1 << sensor))
+        {
+            uint16_t& port = map.port[sensor] ? port_1 : port_0;
+            port |= 1 << map.bit[sensor];
+        }
+    }
+}
+
+/** @brief      Filters a batch of samples into one frame by majority vote
+ *  @details    Each sample is packed into a frame first, so the counting loop
+ *              only deals with 8 bits no matter how the pins are wired.
+ */
+uint8_t majority_frame(const IrPinMap& map, const uint16_t* p_port_0,
+                       const uint16_t* p_port_1, uint16_t count)
+{
+    uint16_t votes[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+    for (uint16_t index = 0; index < count; index++)
+    {
+        uint8_t frame = pack_ir_sample(map, p_port_0[index], p_port_1[index]);
+        for (uint8_t sensor = 0; sensor < 8; sensor++)
+        {
+            votes[sensor] += (frame >> sensor) & 1;
+        }
+    }
+
+    uint8_t result = 0;
+    for (uint8_t sensor = 0; sensor < 8; sensor++)
+    {
+        if (2 * votes[sensor] > count)
+        {
+            result |= 1 << sensor;
+        }
+    }
+    return result;
+}
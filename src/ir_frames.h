@@ -0,0 +1,61 @@
+/** @file   ir_frames.h
+ *  @brief  This file contains functions which turn raw GPIO port samples
+ *          into IR frames, and which filter several samples of the same
+ *          frame into one. They have no hardware dependencies so the DMA
+ *          capture on the nucleo and its PC stand-in share them.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ */
+
+
+#ifndef IR_FRAMES_H
+#define IR_FRAMES_H
+
+#include <stdint.h>
+
+/** @brief   Where each of the 8 IR sensors can be found in the GPIO ports.
+ *  @details The sensors may be spread over two ports; each sensor has the
+ *           number of its port (0 or 1) and its bit within that port's input
+ *           data register.
+ */
+struct IrPinMap
+{
+    uint8_t port[8];                ///< Port (0 or 1) of sensors 1 to 8
+    uint8_t bit[8];                 ///< Bit in the port of sensors 1 to 8
+};
+
+/** @brief      Builds an IR frame from one sample of both ports
+ *
+ *  @param      map     Where each sensor is found in the ports
+ *  @param      port_0  Sample of the first port's input data register
+ *  @param      port_1  Sample of the second port's input data register
+ *  @return     Frame in the same format as IR_Array::getFrame()
+ */
+uint8_t pack_ir_sample(const IrPinMap& map, uint16_t port_0, uint16_t port_1);
+
+/** @brief      Builds the port samples which would give an IR frame
+ *  @details    This is the opposite of pack_ir_sample(), used to make test
+ *              data; bits which don't belong to a sensor are left at 0.
+ */
+void unpack_ir_sample(const IrPinMap& map, uint8_t frame,
+                      uint16_t& port_0, uint16_t& port_1);
+
+/** @brief      Filters a batch of samples into one frame by majority vote
+ *  @details    Each sensor's bit is set in the result if it was set in more
+ *              than half of the samples, which removes short glitches from
+ *              ambient light or electrical noise.
+ *
+ *  @param      map         Where each sensor is found in the ports
+ *  @param      p_port_0    Samples of the first port
+ *  @param      p_port_1    Samples of the second port
+ *  @param      count       Number of samples of each port
+ *  @return     The filtered frame
+ */
+uint8_t majority_frame(const IrPinMap& map, const uint16_t* p_port_0,
+                       const uint16_t* p_port_1, uint16_t count);
+
+#endif //end if: define IR frame declarations
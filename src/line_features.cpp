@@ -0,0 +1,61 @@
+/** @file   line_features.cpp
+ *  @brief  This file contains the definitions of the functions which measure
+ *          the shape of the line under the IR array.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ */
+
+#include "line_features.h"
+
+/** @brief      Measures the line in one frame
+ *  @details    A piece of line starts at each sensor which sees the line
+ *              while the sensor on its passenger side doesn't, so
+ *              <tt>frame & ~(frame << 1)</tt> has one bit per piece. The
+ *              edges come from counting the zeros below the lowest set bit
+ *              and above the highest one, which the processor does with its
+ *              @c RBIT and @c CLZ instructions.
+ */
+LineFeatures extract_line_features(uint8_t frame)
+{
+    LineFeatures features = {0, 0, 0, 0, 0, LINE_NONE};
+    if (frame == 0)
+    {
+        return features;
+    }
+
+    features.width = count_bits(frame);
+    features.segments = count_bits(frame & ~(frame << 1));
+    features.right_edge = (uint8_t)__builtin_ctz(frame);
+    features.left_edge = (uint8_t)(31 - __builtin_clz(frame));
+    features.center = (int8_t)(features.left_edge + features.right_edge - 7);
+
+    if (features.segments > 1)
+    {
+        features.kind = LINE_SPLIT;
+    }
+    else if (features.width >= 7)
+    {
+        features.kind = LINE_CROSSING;
+    }
+    else if (features.width < 4)
+    {
+        features.kind = LINE_SINGLE;
+    }
+    else if (frame & 0x80)
+    {
+        features.kind = LINE_CORNER_LEFT;
+    }
+    else if (frame & 0x01)
+    {
+        features.kind = LINE_CORNER_RIGHT;
+    }
+    else
+    {
+        features.kind = LINE_WIDE;
+    }
+    return features;
+}
@@ -0,0 +1,72 @@
+/** @file   line_features.h
+ *  @brief  This file contains functions which measure the shape of the line
+ *          under the IR array from one frame.
+ *  @details Besides which of the five drive state patterns it matches, a
+ *           frame shows how wide the line is, where its edges are, how many
+ *           separate pieces of line there are and whether it looks like a
+ *           sharp corner or a T or cross intersection. All of these are found
+ *           with a few bit operations on the 8 bit frame. The frame is the
+ *           only input, so the replay tool can find the same features in a
+ *           recorded trace, and the simulated robots in frames made up from
+ *           a track model.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ */
+
+
+#ifndef LINE_FEATURES_H
+#define LINE_FEATURES_H
+
+#include <stdint.h>
+
+/// What kind of line a frame shows
+enum LineKind : uint8_t
+{
+    LINE_NONE = 0,                  ///< No sensor sees the line
+    LINE_SINGLE = 1,                ///< One piece of line, 1 to 3 sensors wide
+    LINE_WIDE = 2,                  ///< One piece, 4 or more wide, not at an end
+    LINE_CORNER_LEFT = 3,           ///< 4 or more wide, reaching sensor 8
+    LINE_CORNER_RIGHT = 4,          ///< 4 or more wide, reaching sensor 1
+    LINE_CROSSING = 5,              ///< 7 or 8 sensors; a T or a cross
+    LINE_SPLIT = 6                  ///< Two or more separate pieces of line
+};
+
+/** @brief   The shape of the line in one frame.
+ *  @details Sensor numbers here count from 0 for sensor 1 (passenger side,
+ *           bit 0) to 7 for sensor 8 (driver side, bit 7).
+ */
+struct LineFeatures
+{
+    uint8_t width;                  ///< Number of sensors which see the line
+    uint8_t segments;               ///< Number of separate pieces of line
+    uint8_t right_edge;             ///< Lowest sensor which sees the line
+    uint8_t left_edge;              ///< Highest sensor which sees the line
+    int8_t center;                  ///< Middle of the edges in half sensors,
+                                    ///< from -7 (sensor 1) to 7 (sensor 8)
+    LineKind kind;                  ///< What kind of line this looks like
+};
+
+/** @brief      Counts the bits which are set in a byte
+ *  @details    The Cortex-M4 has no population count instruction, so rather
+ *              than calling the library's 32 bit routine the bits are added
+ *              in pairs, then nibbles, in three steps.
+ */
+inline uint8_t count_bits(uint8_t bits)
+{
+    bits = bits - ((bits >> 1) & 0x55);
+    bits = (bits & 0x33) + ((bits >> 2) & 0x33);
+    return (bits + (bits >> 4)) & 0x0F;
+}
+
+/** @brief      Measures the line in one frame
+ *
+ *  @param      frame   Frame from IR_Array::getFrame(), bit 0 is sensor 1
+ *  @return     The features of the line; all zero if the frame is empty
+ */
+LineFeatures extract_line_features(uint8_t frame);
+
+#endif //end if: define line feature declarations
@@ -1,305 +1,1060 @@
 /** @file main.cpp
  *      This file contains a program that runs our term project cleanbot. The
- *      microcontroller is being used to communicate with mutiple sensors including 
+ *      microcontroller is being used to communicate with mutiple sensors including
  *      an IR sensor array, two motors, and a WiFi reciever, all running
  *      the arduinio framework.
  *
  *  @author  WC Montgomery, A Recidoro, A Haduong
- * 
+ *
  *  @date    05 Nov 2020    Original file
+ *  @date    18 Oct 2026    Decision logic moved to drive_logic.cpp, added
+ *                          trace recording (build with CLEANBOT_RECORD)
+ *  @date    18 Oct 2026    Shares defined here, share statistics printed by
+ *                          the diagnostics task
+ *  @date    18 Oct 2026    Deadline monitor and drive train freshness guard
+ *  @date    18 Oct 2026    IR array can be sampled by DMA (CLEANBOT_IR_DMA)
+ *  @date    18 Oct 2026    Shares between tasks replaced by topics, and the
+ *                          drive train reads one drive command per cycle
+ *  @date    18 Oct 2026    Motors driven by MotorOutput, which only writes
+ *                          the timers when a speed changes
+ *  @date    18 Oct 2026    Line features published with each frame; the
+ *                          drive state comes from the line tracker
+ *  @date    18 Oct 2026    Each task split into a setup and a step function,
+ *                          so the same code runs from a cyclic executive
+ *                          (CLEANBOT_CYCLIC_EXEC); every task is periodic
+ *  @date    18 Oct 2026    Encoder task keeps the odometry; the IR array task
+ *                          learns the route and looks ahead along it
+ *  @date    18 Oct 2026    LED task lights the lamp while running and keeps
+ *                          the UV dose of the floor, which sets the speed
+ *  @date    18 Oct 2026    Every periodic task has a deadline; the freshness
+ *                          guard uses the drive command's sequence number
+ *  @date    18 Oct 2026    The lamp's speed limit is recorded in the trace
+ *  @date    18 Oct 2026    Trace recorded into two buffers, one printed at
+ *                          115200 baud while the other fills
  */
 
 #include <Arduino.h>
 #include <STM32FreeRTOS.h>
 #include <ir_array.h>
 #include <motor_driver.h>
+#include <motor_output.h>
 #include <wifi_system.h>
-#include <taskshare.h>
+#include <topics.h>
+#include <drive_logic.h>
+#include <encoder.h>
+#include <route_map.h>
+#include <coverage_grid.h>
+#include <trace.h>
+#include <deadline_monitor.h>
+#ifdef CLEANBOT_IR_DMA
+    #include <ir_dma.h>
+#endif
+#ifdef CLEANBOT_CYCLIC_EXEC
+    #include <cyclic_exec.h>
+#endif
+
+#if (defined CLEANBOT_CYCLIC_EXEC && defined CLEANBOT_IR_DMA)
+    #error "The DMA capture wakes its task from an interrupt, which needs FreeRTOS"
+#endif
+
+
+/// Time between runs of the IR array task in milliseconds
+const uint32_t IR_PERIOD_MS = 5;
+
+/// Time between runs of the drive train task in milliseconds
+const uint32_t DRIVE_PERIOD_MS = 1;
+
+/// Time between runs of the encoder task in milliseconds
+const uint32_t ENCODER_PERIOD_MS = 5;
+
+/// Time between runs of the WiFi and LED tasks in milliseconds
+const uint32_t WIFI_PERIOD_MS = 10;
+
+/// Time between runs of the diagnostics and trace tasks in milliseconds
+const uint32_t DIAGNOSTICS_PERIOD_MS = 100;
+
+#ifdef CLEANBOT_RECORD
+/// Serial speed, fast enough to print one trace buffer before the other fills
+const uint32_t SERIAL_BAUD = 115200;
+#else
+/// Serial speed for the diagnostics printouts
+const uint32_t SERIAL_BAUD = 9600;
+#endif
+
+/// Checks that the IR array task reads the sensors every 5 ms
+Deadline IR_deadline ("IR Array", IR_PERIOD_MS);
+
+/// Checks that the drive train updates the motors every millisecond
+Deadline drive_deadline ("Drive Train", DRIVE_PERIOD_MS);
+
+/// Checks that the encoder task reads the encoders every 5 ms
+Deadline encoder_deadline ("Encoders", ENCODER_PERIOD_MS);
+
+/// Checks that the WiFi task looks for the run signal every 10 ms
+Deadline wifi_deadline ("WiFi", WIFI_PERIOD_MS);
+
+/// Checks that the LED task doses the floor every 10 ms
+Deadline led_deadline ("LED", WIFI_PERIOD_MS);
+
+/// Checks that the diagnostics task runs every 100 ms
+Deadline diagnostics_deadline ("Diagnostics", DIAGNOSTICS_PERIOD_MS);
+
+/// Slows the drive train after 20 ms without a new drive command and stops
+/// it after 100 ms
+FreshnessGuard drive_guard (20, 100);
+
+/// Drives both motors' PWM and direction pins for the drive train task
+MotorOutput motor_output (MOTOR_PWM_HZ);
+
+/// Measures how much of the processor's time is left over
+IdleMeter idle_meter;
+
+#ifdef CLEANBOT_CYCLIC_EXEC
+/// Runs the task step functions from the schedule table at the end of file
+extern CyclicExecutive executive;
+#endif
+
+#ifdef CLEANBOT_RECORD
+/// Size of each of the two buffers in which a trace of the CleanBot's run
+/// is recorded
+const size_t TRACE_BUFFER_SIZE = 8192;
+
+/// Memory which holds the traces; the tasks record into one buffer while
+/// the trace task prints the other
+static uint8_t trace_buffers[2][TRACE_BUFFER_SIZE];
+
+/// Writes records into @c trace_buffers, one writer for each buffer
+static TraceWriter trace_writers[2] =
+{
+    TraceWriter (trace_buffers[0], TRACE_BUFFER_SIZE),
+    TraceWriter (trace_buffers[1], TRACE_BUFFER_SIZE)
+};
+
+/// The writer which the tasks record into
+static TraceWriter* p_trace_writer = &trace_writers[0];
+
+/// A full writer waiting for the trace task to print it, or NULL if none
+static TraceWriter* p_full_trace = NULL;
+
+/// Checks that the trace task looks at the buffers every 100 ms
+Deadline trace_deadline ("Trace", DIAGNOSTICS_PERIOD_MS);
+
+/** @brief   Hands the full trace to the trace task and records into the
+ *           other buffer.
+ *  @details Call in a critical section when a record didn't fit. If the
+ *           other buffer hasn't been printed yet, there is nowhere to put
+ *           the record and it is lost.
+ *  @return  True if recording moved to the other buffer
+ */
+static bool swap_trace_buffers (void)
+{
+    if (p_full_trace != NULL)
+    {
+        return false;
+    }
+    p_full_trace = p_trace_writer;
+    p_trace_writer = (p_trace_writer == &trace_writers[0])
+                     ? &trace_writers[1] : &trace_writers[0];
+    return true;
+}
+#endif
+
+/** @brief   Records a frame from the IR array if this is a recording build.
+ *  @param   frame The frame from @c IR_Array::getFrame()
+ */
+static inline void record_ir_frame (uint8_t frame)
+{
+#ifdef CLEANBOT_RECORD
+    SHARE_ENTER_CRITICAL ();
+    uint32_t now = micros ();
+    if (!p_trace_writer->ir_frame (now, frame) && swap_trace_buffers ())
+    {
+        p_trace_writer->ir_frame (now, frame);
+    }
+    SHARE_EXIT_CRITICAL ();
+#else
+    (void) frame;
+#endif
+}
+
+/** @brief   Records the WiFi run signal when it changes, if recording.
+ *  @param   enable True if the CleanBot has been told to run
+ */
+static inline void record_wifi (bool enable)
+{
+#ifdef CLEANBOT_RECORD
+    static bool recorded = false;
+    static bool last_enable;
+    if (!recorded || enable != last_enable)
+    {
+        SHARE_ENTER_CRITICAL ();
+        uint32_t now = micros ();
+        recorded = p_trace_writer->wifi (now, enable)
+                   || (swap_trace_buffers ()
+                       && p_trace_writer->wifi (now, enable));
+        SHARE_EXIT_CRITICAL ();
+        last_enable = enable;
+    }
+#else
+    (void) enable;
+#endif
+}
+
+/** @brief   Records the encoder counts when they change, if recording.
+ *  @param   left  Count from the left encoder
+ *  @param   right Count from the right encoder
+ */
+static inline void record_encoders (int32_t left, int32_t right)
+{
+#ifdef CLEANBOT_RECORD
+    static bool recorded = false;
+    static int32_t last_left;
+    static int32_t last_right;
+    if (!recorded || left != last_left || right != last_right)
+    {
+        SHARE_ENTER_CRITICAL ();
+        uint32_t now = micros ();
+        recorded = p_trace_writer->encoders (now, left, right)
+                   || (swap_trace_buffers ()
+                       && p_trace_writer->encoders (now, left, right));
+        SHARE_EXIT_CRITICAL ();
+        last_left = left;
+        last_right = right;
+    }
+#else
+    (void) left;
+    (void) right;
+#endif
+}
+
+/** @brief   Records the motor speeds when they change, if recording.
+ *  @param   left  Speed given to the left motor
+ *  @param   right Speed given to the right motor
+ */
+static inline void record_motors (int16_t left, int16_t right)
+{
+#ifdef CLEANBOT_RECORD
+    static bool recorded = false;
+    static int16_t last_left;
+    static int16_t last_right;
+    if (!recorded || left != last_left || right != last_right)
+    {
+        SHARE_ENTER_CRITICAL ();
+        uint32_t now = micros ();
+        recorded = p_trace_writer->motors (now, left, right)
+                   || (swap_trace_buffers ()
+                       && p_trace_writer->motors (now, left, right));
+        SHARE_EXIT_CRITICAL ();
+        last_left = left;
+        last_right = right;
+    }
+#else
+    (void) left;
+    (void) right;
+#endif
+}
+
+/** @brief   Records the lamp and its speed limit when they change, if
+ *           recording.
+ *  @param   status The latest status from the LED task
+ */
+static inline void record_lamp (const LampStatus& status)
+{
+#ifdef CLEANBOT_RECORD
+    static bool recorded = false;
+    static LampStatus last_status;
+    if (!recorded || status.lamp_on != last_status.lamp_on
+        || status.speed_percent != last_status.speed_percent)
+    {
+        SHARE_ENTER_CRITICAL ();
+        uint32_t now = micros ();
+        recorded = p_trace_writer->lamp (now, status.lamp_on,
+                                         status.speed_percent)
+                   || (swap_trace_buffers ()
+                       && p_trace_writer->lamp (now, status.lamp_on,
+                                                status.speed_percent));
+        SHARE_EXIT_CRITICAL ();
+        last_status = status;
+    }
+#else
+    (void) status;
+#endif
+}
+
 
+/// The left motor, on PHASE pin 5 and ENABLE pin 3
+static Motor_Driver leftMotor;
+
+/// The right motor, on PHASE pin 6 and ENABLE pin 9
+static Motor_Driver rightMotor;
+
+/// The drive train's subscription to the IR array task's drive commands
+static Subscriber<DriveCommand>* p_drive_commands = NULL;
+
+/// The drive command used in the latest cycle of the drive train
+static DriveCommand drive_command = {false, 0xFF, 0, 0};
+
+/// True once the motor timers have been set up
+static bool motors_ready = false;
+
+/** @brief   Sets up the motors for the drive train task.
+ *  @details The subscriber is made here rather than at file scope, since
+ *           under FreeRTOS it must not be made before the scheduler starts.
+ *  @return  False if the motor pins can't be driven by a PWM timer
+ */
+static bool drive_train_init (void)
+{
+    p_drive_commands = new Subscriber<DriveCommand> (drive_command_topic,
+                                                     "Drive Train");
+
+    leftMotor.SetPins (5, 3);
+    rightMotor.SetPins(6, 9); // check and make sure the pins are correct
 
-extern Share<bool> wifi_to_motor_share;
-extern Share<uint8_t> driveState_share;
+    motors_ready = motor_output.begin (leftMotor, rightMotor);
+    if (!motors_ready)
+    {
+        Serial.println ("Motor PWM can't be set up on the motor pins");
+    }
+    return motors_ready;
+}
 
-/** @brief   Task which controls CleanBot's motors.
+/** @brief   Runs one cycle of the drive train: controls CleanBot's motors.
  *  @details This task controls the drivetrain system. This includes
  *           controling the motor driver and the motor encoders. This tasks uses
- *           those components to get the cleanbot to go given the information from the 
+ *           those components to get the cleanbot to go given the information from the
  *           vision subsytem. Can go into 5 different drive states:
  *           0: drive in straight line
  *           1: rotate CCW
  *           2: turn left
  *           3: turn right
  *           4: rotate CW
- *           
- *  @param   p_params A pointer to function parameters which we don't use.
+ *           The state and the speed of each wheel arrive together in one
+ *           @c DriveCommand from the IR array task, so the enable flag, state
+ *           and speeds used in each cycle always belong together.
+ *           If no new drive command has been published for a while, the
+ *           speeds are halved and then the motors are stopped; the age is
+ *           taken from the command's sequence number, so this happens even
+ *           if the IR array task is still running.
+ *           The filtered speeds go to @c motor_output every cycle, but it
+ *           only writes the timers when a speed has changed.
  */
-void task_drive_train(void* p_params)
-{   
-    (void) p_params;
-    bool wifi_flag;
-    uint8_t IR_flag;
-    const uint8_t max_speed= 255;
-    Motor_Driver leftMotor;
-    Motor_Driver rightMotor;
+static void drive_train_step (void)
+{
+    if (!motors_ready)
+    {
+        return;
+    }
+    drive_deadline.check_in ();
 
-    leftMotor.SetPins (5, 3);
-    rightMotor.SetPins(6, 9); // check and make sure the pins are correct
+    // take the newest command; if it's the same one as last time, keep
+    // driving on it and let the freshness guard decide when it's too old
+    p_drive_commands->receive (drive_command);
+    DriveMode mode = drive_guard.update (p_drive_commands->get_sequence ());
+    record_wifi (drive_command.enable);
+    if(drive_command.enable == true)     // checks wifi reciever to see if signal has been sent to turn on
+    {
+      // the IR array task only sends a state once a pattern has matched
+      if (drive_command.state != 0xFF)
+      {
+        int16_t left_speed = drive_command.left_target;
+        int16_t right_speed = drive_command.right_target;
 
-    for (;;)
-    {   
-        wifi_to_motor_share.get (wifi_flag);
-        driveState_share.get (IR_flag);
-        if(wifi_flag == true)     // checks wifi reciever to see if signal has been sent to turn on
+        // hold back the speeds if the drive command has gone stale
+        drive_guard.limit (left_speed, right_speed);
+
+        record_motors (left_speed, right_speed);
+        leftMotor.ChangeSpeed(left_speed);
+        rightMotor.ChangeSpeed(right_speed);
+        if (mode == DRIVE_STOPPED)
         {
-          if(IR_flag == 0)    // check what IR array flag gives and point to right order
-          {
-            // go straight
-
-            leftMotor.ChangeSpeed(.5*max_speed);  // call class of motor driver and set left wheel forward  .5 max speed
-            rightMotor.ChangeSpeed(.5*max_speed); // call class of motor driver and set right wheel forward .5 max speed
-          }                
-          else if(IR_flag == 1)
-          {
-            // rotate counter clockwise
-
-            leftMotor.ChangeSpeed(.5*max_speed);  // call class of motor driver and set left wheel forward .5 max speed
-            rightMotor.ChangeSpeed(-.5*max_speed); // call class of motor driver and set right wheel backward .5 max speed
-          }
-          else if(IR_flag == 2)
-          {
-            // turn left, right wheel spins twice as fast as left
-
-            leftMotor.ChangeSpeed(.25*max_speed); // call class of motor driver and set left wheel to .25 max speed
-            rightMotor.ChangeSpeed(.5*max_speed); // call class of motor driver and set right wheel to .5 max speed
-          }
-          else if (IR_flag == 3)
-          {
-            // turn right, left wheel spins twice as fast as left
-
-            leftMotor.ChangeSpeed(.5*max_speed);  // call class of motor driver and set left wheel to .5 max speed
-            rightMotor.ChangeSpeed(.25*max_speed); // call class of motor driver and set right wheel to .25 max speed
-          }
-          else if (IR_flag == 4)
-          {
-            // rotate clockwise
-
-            leftMotor.ChangeSpeed(-.5*max_speed);  // call class of motor driver and set left wheel backward .5 max speed
-            rightMotor.ChangeSpeed(.5*max_speed); // call class of motor driver and set right wheel forward .5 max speed
-          }
+          // don't wait for the filter to wind down
+          leftMotor.Stop();
+          rightMotor.Stop();
         }
-
+      }
+    }
+    else
+    {
+      leftMotor.Stop();
+      rightMotor.Stop();
     }
+
+    motor_output.apply (leftMotor.GetOutput(), rightMotor.GetOutput());
 }
 
-/** @brief   Task which gets information from IR array
+
+//create int values to hold which pins of the microcontroller the IR Array is connected to
+static uint8_t IR_sensor_pins [8] = {2, 4, 7, 8, 10, 11, 12, 13};
+
+#ifndef CLEANBOT_IR_DMA
+/// The IR array, read by polling its pins
+static IR_Array* p_line_array = NULL;
+#else
+/// The DMA capture unit which samples the IR array's pins, made by the IR
+/// array task and printed by the diagnostics task
+static IR_DMA_Capture* p_ir_capture = NULL;
+#endif
+
+/// What the line tracker remembers between frames; no pattern has matched
+/// yet, so there is no drive state to keep
+static LineTracker line_tracker;
+
+/// max_speed of 255 and the tuned speeds
+static const DriveParams drive_params;
+
+/// The IR array task's subscription to the WiFi task's run signal
+static Subscriber<bool>* p_run_signal = NULL;
+
+/// The IR array task's subscription to the encoder task's odometry
+static Subscriber<Odometry>* p_odometry = NULL;
+
+/// The latest odometry from the encoder task
+static Odometry odometry = {};
+
+/// The route, learned on the first lap; over 1 KB, so kept off the stack
+static RouteMap route_map;
+
+/// The IR array task's subscription to the LED task's lamp status
+static Subscriber<LampStatus>* p_lamp_status = NULL;
+
+/// The latest lamp status; full speed until the LED task says otherwise
+static LampStatus lamp_status = {false, 100};
+
+/// The CleanBot stays still until the WiFi task says it may run
+static bool run_enable = false;
+
+/** @brief   Sets up the IR array and the topics the IR array task uses.
+ *  @details In DMA builds the capture unit is set up by the task itself.
+ */
+static void IR_array_init (void)
+{
+    p_run_signal = new Subscriber<bool> (run_topic, "IR Array");
+    p_odometry = new Subscriber<Odometry> (odometry_topic, "IR Array");
+    p_lamp_status = new Subscriber<LampStatus> (lamp_topic, "IR Array");
+#ifndef CLEANBOT_IR_DMA
+    //create IR_Array object with pin values connected to the microcontroller
+    p_line_array = new IR_Array(IR_sensor_pins);
+#endif
+}
+
+/** @brief   Turns one frame from the IR array into a drive command.
  *  @details lets IR array see whether it senses a black line on the ground
  *           and gives the proper instructions to the drive train subsystem
- *           using a uint8_t share. Runs every 5 ms and sets a drive state:
+ *           by publishing a @c DriveCommand, which holds the run signal from
+ *           the WiFi task, the drive state and the wheel speeds chosen by
+ *           @c drive_speeds(). The frame and drive state are also published
+ *           on @c line_topic for the diagnostics task. Sets a drive state:
  *           0: drive in straight line
  *           1: rotate CCW
  *           2: turn left
  *           3: turn right
  *           4: rotate CW
- * 
+ *           The sensor patterns for each state are in @c classify_frame().
+ *           Frames which match none of them, such as intersections, sharp
+ *           corners or a lost line, are handled by @c track_line() using the
+ *           line's width, edges and number of pieces, which are published
+ *           with the frame.
+ *           The route map is given the latest odometry and the kind of
+ *           line, and its advice slows the CleanBot before the curves it
+ *           has learned and starts the turn into them; see
+ *           @c route_drive(). While the UV lamp is lit, the speed is also
+ *           held down to the one the LED task's coverage grid asks for.
+ *  @param   frame Bitmask of the sensors which see the line
+ */
+static void handle_IR_frame (uint8_t frame)
+{
+    record_ir_frame (frame);
+
+    LineReading& reading = line_topic.claim ();
+    reading.frame = frame;
+    reading.features = extract_line_features (frame);
+    reading.drive_state = track_line (line_tracker, frame, reading.features);
+    uint8_t drive_state = reading.drive_state;
+    line_topic.publish ();
+
+    // fill in the whole drive command so the drive train never sees the
+    // state from one frame with the speeds from another
+    p_run_signal->receive (run_enable);
+    p_odometry->receive (odometry);
+    route_map.update (odometry, reading.features.kind);
+    RouteAdvice advice = route_map.advise ();
+    p_lamp_status->receive (lamp_status);
+    record_lamp (lamp_status);
+    if (lamp_status.lamp_on && lamp_status.speed_percent < advice.speed_percent)
+    {
+        advice.speed_percent = lamp_status.speed_percent;
+    }
+
+    DriveCommand& command = drive_command_topic.claim ();
+    command.enable = run_enable;
+    command.state = route_drive (advice, drive_state, drive_params,
+                                 command.left_target, command.right_target);
+    drive_command_topic.publish ();
+}
+
+#ifndef CLEANBOT_IR_DMA
+/** @brief   Runs one cycle of the IR array task, every 5 ms.
+ *  @details All 8 sensors are read at once; bit 0 of the frame is sensor 1
+ *           (passenger side) and bit 7 is sensor 8 (driver side).
+ */
+static void IR_array_step (void)
+{
+    IR_deadline.check_in ();
+    handle_IR_frame (p_line_array->getFrame());
+}
+#endif
+
+
+/** @brief   Runs one cycle of the WiFi task.
+ *  @details This task uses the ESP8266 WiFi module to determine if it is safe
+ *           for the CleanBot to be running. If a WiFi signal is detected, then
+ *           a value of TRUE is published on @c run_topic so that the
+ *           CleanBot will run. Otherwise, a value of FALSE is published.
+ */
+static void wifi_step (void)
+{
+    wifi_deadline.check_in ();
+
+    // call wifi reciever function and publish the result on run_topic
+
+    // code that turns CleanBot On/off depending on if
+    // signal has been sent. Send a share to drive train task
+    // needs to be true for rest of the task to run
+    // and LED to be on
+
+    // will put a boolean into wifi_flag
+}
+
+/// Pin which switches the UV lamp, or the LEDs standing in for it
+const uint8_t UV_LAMP_PIN = A4;
+
+/// Dose periods of the coverage grid in each run of the LED task
+const uint8_t LED_DOSE_PERIODS = WIFI_PERIOD_MS / COVERAGE_DOSE_MS;
+
+/// The LED task's subscription to the WiFi task's run signal
+static Subscriber<bool>* p_lamp_run = NULL;
+
+/// The LED task's subscription to the encoder task's odometry
+static Subscriber<Odometry>* p_lamp_odometry = NULL;
+
+/// The lamp is only lit while the CleanBot is allowed to run
+static bool lamp_on = false;
+
+/// Where the LED task last saw the CleanBot
+static Odometry lamp_odometry = {};
+
+/// UV dose of the floor around the start; 4 KB, so kept off the stack
+static CoverageGrid coverage;
+
+/** @brief   Sets up the lamp pin and the topics the LED task uses.
+ */
+static void led_init (void)
+{
+    p_lamp_run = new Subscriber<bool> (run_topic, "LED");
+    p_lamp_odometry = new Subscriber<Odometry> (odometry_topic, "LED");
+    pinMode (UV_LAMP_PIN, OUTPUT);
+    digitalWrite (UV_LAMP_PIN, LOW);
+}
+
+/** @brief   Runs one cycle of the LED task.
+ *  @details This task turns on or off a digital pin assigned to the UV light
+ *           control. For this prototype, LEDs will be used in place of UV lights
+ *           as a more suitable replacement. The lamp is lit while the WiFi
+ *           task says the CleanBot may run. Each cycle the lamp's dose is
+ *           added to the coverage grid at the latest odometry, and the
+ *           speed which gives the floor ahead the dose it still needs is
+ *           published on @c lamp_topic for the IR array task.
+ */
+static void led_step (void)
+{
+    led_deadline.check_in ();
+    p_lamp_run->receive (lamp_on);
+    p_lamp_odometry->receive (lamp_odometry);
+    digitalWrite (UV_LAMP_PIN, lamp_on ? HIGH : LOW);
+
+    coverage.expose (lamp_odometry, lamp_on, LED_DOSE_PERIODS);
+
+    LampStatus& status = lamp_topic.claim ();
+    status.lamp_on = lamp_on;
+    status.speed_percent = coverage.speed_percent (lamp_odometry);
+    lamp_topic.publish ();
+}
+
+/// The left encoder, on channel A pin A0 and channel B pin A1
+static Encoder leftEncoder;
+
+/// The right encoder, on channel A pin A2 and channel B pin A3; its motor
+/// faces the other way, so it counts down when driving forward
+static Encoder rightEncoder;
+
+/// Size of the wheels and encoders
+static const OdometryParams odometry_params;
+
+/// Where the encoder task has worked out the CleanBot is
+static Odometry dead_reckoning = {};
+
+/** @brief   Starts counting the encoder pulses for the encoder task.
+ */
+static void encoder_init (void)
+{
+    leftEncoder.SetPins (A0, A1);
+    rightEncoder.SetPins (A2, A3, true);
+}
+
+/** @brief   Runs one cycle of the encoder task.
+ *  @details This task reads the counts of the magnetic encoders, which are
+ *           kept up to date by their interrupts, and works out from them
+ *           where the CleanBot has driven. The odometry is published on
+ *           @c odometry_topic for the IR array task's route map.
+ */
+static void encoder_step (void)
+{
+    encoder_deadline.check_in ();
+    int32_t left_count = leftEncoder.GetCount ();
+    int32_t right_count = rightEncoder.GetCount ();
+    record_encoders (left_count, right_count);
+
+    update_odometry (dead_reckoning, left_count, right_count,
+                     odometry_params);
+    odometry_topic.publish (dead_reckoning);
+}
+
+/** @brief   Prints what the route map has learned.
+ *  @param   printer The serial port to print on
+ */
+static void print_route_map (Print& printer)
+{
+    printer.print ("Route map: ");
+    printer.print (route_map.get_mode () == ROUTE_FOLLOWING
+                   ? "following, lap " : "learning, lap ");
+    printer.print (route_map.get_lap_mm ());
+    printer.print (" mm, ");
+    printer.print (route_map.get_laps ());
+    printer.print (" laps, ");
+    printer.print (route_map.get_relearns ());
+    printer.print (" relearns, ");
+    printer.print (route_map.get_resyncs ());
+    printer.print (" resyncs, ");
+    printer.print (route_map.get_overflows ());
+    printer.println (" overflows");
+}
+
+/** @brief   Prints how much of the floor has had its UV dose.
+ *  @param   printer The serial port to print on
+ */
+static void print_coverage (Print& printer)
+{
+    printer.print ("Coverage: ");
+    printer.print (coverage.get_dosed ());
+    printer.print (" of ");
+    printer.print (coverage.get_touched ());
+    printer.print (" cells done (");
+    printer.print (coverage.coverage_percent ());
+    printer.print (" %), lamp on ");
+    printer.print (coverage.get_lamp_ms () / 1000);
+    printer.print (" s, ");
+    uint32_t left_ms = coverage.completion_ms ();
+    if (left_ms == UINT32_MAX)
+    {
+        printer.println ("time left unknown");
+    }
+    else
+    {
+        printer.print (left_ms / 1000);
+        printer.println (" s left");
+    }
+}
+
+/// The diagnostics task's subscription to the IR array task's line readings
+static Subscriber<LineReading>* p_line_readings = NULL;
+
+/** @brief   Sets up the topics the diagnostics task reads.
+ */
+static void diagnostics_init (void)
+{
+    p_line_readings = new Subscriber<LineReading> (line_topic, "Diagnostics");
+}
+
+/** @brief   Prints what the IR array saw in its latest frame.
+ *  @details Only a few fields are wanted, so the reading is looked at where
+ *           it lies in the topic rather than copied out.
+ *  @param   printer The serial port to print on
+ */
+static void print_line_reading (Print& printer)
+{
+    uint8_t frame = 0;
+    uint8_t kind = LINE_NONE;
+    int8_t center = 0;
+    uint8_t drive_state = 0xFF;
+    uint32_t fresh = p_line_readings->peek ([&] (const LineReading& newest)
+    {
+        frame = newest.frame;
+        kind = newest.features.kind;
+        center = newest.features.center;
+        drive_state = newest.drive_state;
+    });
+    if (p_line_readings->get_sequence () == 0)
+    {
+        printer.println ("Line: no frames yet");
+        return;
+    }
+
+    printer.print ("Line: frame 0x");
+    printer.print (frame, HEX);
+    printer.print (", kind ");
+    printer.print (kind);
+    printer.print (", center ");
+    printer.print (center);
+    printer.print (", drive state ");
+    printer.print (drive_state);
+    printer.print (", ");
+    printer.print (fresh);
+    printer.println (" frames since the last printout");
+}
+
+/** @brief   Runs one cycle of the diagnostics task.
+ *  @details Whenever a character is received on the serial port, this task
+ *           prints a table of every share and topic with how many times it has
+ *           been written and read, how long ago it was last written and the
+ *           longest time spent in one of its critical sections. A share which
+ *           is read far more often than it is written, or which hasn't been
+ *           written for a long time, shows up straight away. Under each
+ *           topic, its subscribers show how many messages they skipped. It
+ *           then prints the missed deadlines, worst lateness and earliness of
+ *           each periodic task, in DMA builds the IR frames the capture
+ *           overwrote before they were read, the drive train's current
+ *           mode, how often the motor timers were written and the share of
+ *           time the processor was idle, the IR array's latest frame, what
+ *           the route map has learned and how much of the floor has had its
+ *           UV dose. The cyclic executive build also
+ *           prints how long each slot of the schedule took.
+ */
+static void diagnostics_step (void)
+{
+    diagnostics_deadline.check_in ();
+    if (Serial.available ())
+    {
+        // Throw away whatever was typed; any key asks for a printout
+        while (Serial.available ())
+        {
+            Serial.read ();
+        }
+        print_all_shares (Serial);
+        print_all_deadlines (Serial);
+#ifdef CLEANBOT_IR_DMA
+        if (p_ir_capture != NULL)
+        {
+            p_ir_capture->print (Serial);
+        }
+#endif
+        drive_guard.print (Serial);
+        motor_output.print (Serial);
+        print_line_reading (Serial);
+        print_route_map (Serial);
+        print_coverage (Serial);
+#ifdef CLEANBOT_CYCLIC_EXEC
+        executive.print (Serial);
+#endif
+        idle_meter.print (Serial);
+    }
+}
+
+#ifdef CLEANBOT_RECORD
+/** @brief   Prints a recorded trace once its buffer is full.
+ *  @details The trace is printed as lines of hexadecimal which start with
+ *           @c TRACE: so they can be picked out of a serial monitor log and
+ *           given to the host replay tool. The tasks go on recording into
+ *           the other buffer meanwhile. At 115200 baud a buffer prints in
+ *           under 2 s, which is less time than the tasks take to fill the
+ *           other one, so no records are lost between dumps.
+ */
+static void trace_dump_step (void)
+{
+    const size_t BYTES_PER_LINE = 32;
+
+    trace_deadline.check_in ();
+    SHARE_ENTER_CRITICAL ();
+    TraceWriter* p_full = p_full_trace;
+    SHARE_EXIT_CRITICAL ();
+    if (p_full != NULL)
+    {
+        // No other task writes to the full buffer until it's handed back,
+        // so it is safe to print it without a critical section
+        const uint8_t* p_data = p_full->data ();
+        size_t length = p_full->length ();
+        for (size_t line = 0; line < length; line += BYTES_PER_LINE)
+        {
+            Serial.print ("TRACE:");
+            for (size_t index = line;
+                 index < length && index < line + BYTES_PER_LINE; index++)
+            {
+                if (p_data[index] < 0x10)
+                {
+                    Serial.print ('0');
+                }
+                Serial.print (p_data[index], HEX);
+            }
+            Serial.println ();
+        }
+
+        p_full->reset ();
+        SHARE_ENTER_CRITICAL ();
+        p_full_trace = NULL;
+        SHARE_EXIT_CRITICAL ();
+    }
+}
+#endif
+
+
+#ifdef CLEANBOT_CYCLIC_EXEC
+/** @brief   The schedule which the cyclic executive runs.
+ *  @details Each task runs at the same rate as its FreeRTOS version. The
+ *           slower tasks are spread across different frames so no frame has
+ *           more than one of them along with the drive train, and the
+ *           budgets are checked against the frame length when this file is
+ *           compiled. The diagnostics and trace budgets only cover a frame
+ *           with nothing to print; a printout takes far longer, even at the
+ *           115200 baud of a recording build, and shows up as overrun
+ *           frames.
+ */
+static constexpr CyclicSlot schedule[] =
+{
+    // step function      name            period  offset  budget us
+    { IR_array_step,      "IR Array",     5,      0,      150 },
+    { drive_train_step,   "Drive Train",  1,      0,      60 },
+    { encoder_step,       "Encoders",     5,      1,      50 },
+    { wifi_step,          "WiFi",         10,     2,      50 },
+    { led_step,           "LED",          10,     3,      150 },
+    { diagnostics_step,   "Diagnostics",  100,    4,      400 },
+#ifdef CLEANBOT_RECORD
+    { trace_dump_step,    "Trace",        100,    9,      400 },
+#endif
+};
+CYCLE_SCHEDULE_FITS (schedule);
+
+/// Number of slots in the schedule
+const uint8_t SCHEDULE_SLOTS = sizeof (schedule) / sizeof (schedule[0]);
+
+/// What the executive measures about each slot
+static SlotTiming schedule_timings[SCHEDULE_SLOTS];
+
+/// Runs the task step functions from the schedule table
+CyclicExecutive executive (schedule, schedule_timings, SCHEDULE_SLOTS,
+                           idle_meter);
+
+#else
+
+/** @brief   Task which controls CleanBot's motors, every millisecond.
+ *  @details See @c drive_train_step() for what is done in each cycle.
+ *  @param   p_params A pointer to function parameters which we don't use.
+ */
+void task_drive_train(void* p_params)
+{
+    (void) p_params;
+    if (!drive_train_init ())
+    {
+        for (;;)
+        {
+            vTaskDelay (1000);
+        }
+    }
+
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    for (;;)
+    {
+        drive_train_step ();
+        vTaskDelayUntil (&xLastWakeTime, DRIVE_PERIOD_MS);
+    }
+}
+
+/** @brief   Task which gets information from IR array
+ *  @details Runs every 5 ms and gives each frame to @c handle_IR_frame().
+ *           In builds with @c CLEANBOT_IR_DMA defined, a timer and DMA sample
+ *           the sensors at @c IR_DMA_SAMPLE_HZ and this task wakes once per
+ *           5 ms frame to take a majority vote of that frame's samples.
+ *
  *  @param   p_params A pointer to function parameters which we don't use.
  */
 void task_IR_array (void* p_params)
-{   
+{
   (void) p_params;
-    //Timing of the task: 5 ms between sensor reads
-    const TickType_t TASK_DELAY = 5;
-
-    //create int values to hold which pins of the microcontroller the IR Array is connected to
-    uint8_t IR_Pin_1 = 2;
-    uint8_t IR_Pin_2 = 4;
-    uint8_t IR_Pin_3 = 7;
-    uint8_t IR_Pin_4 = 8;
-    uint8_t IR_Pin_5 = 10;
-    uint8_t IR_Pin_6 = 11;
-    uint8_t IR_Pin_7 = 12;
-    uint8_t IR_Pin_8 = 13;
-    uint8_t sensorPins [8] = {IR_Pin_1, IR_Pin_2, IR_Pin_3, IR_Pin_4, IR_Pin_5, IR_Pin_6, IR_Pin_7, IR_Pin_8};
+    IR_array_init ();
 
-    //create IR_Array object with pin values connected to the microcontroller
-    IR_Array* lineArray = new IR_Array(sensorPins);
+#ifdef CLEANBOT_IR_DMA
+    //create the DMA capture unit, which samples the pins without the processor
+    IR_DMA_Capture* lineArray = new IR_DMA_Capture(IR_sensor_pins, IR_PERIOD_MS, IR_DMA_SAMPLE_HZ);
+    p_ir_capture = lineArray;
+    if (!lineArray->begin())
+    {
+        // the freshness guard will keep the motors stopped
+        Serial.println ("IR DMA capture can't use the IR array's pins");
+        for (;;)
+        {
+            vTaskDelay (1000);
+        }
+    }
 
     for (;;)
     {
-        // call the ir_array task and make variables true depending on which
-        // io any IR sensors were tripped
-        // Sensor 8 is on bot's driver side, sensor 1 is on bot's passenger side
-
-        //drive state 0: drive straight when only the middle sensors 4 and 5 see the line 
-        if (lineArray->getSensor_8() == false && 
-            lineArray->getSensor_7() == false &&
-            lineArray->getSensor_6() == false && 
-            lineArray->getSensor_5() == true && 
-            lineArray->getSensor_4() == true && 
-            lineArray->getSensor_3() == false && 
-            lineArray->getSensor_2() == false &&
-            lineArray->getSensor_1() == false)
-            {
-                driveState_share.put(0);
-            }
-        //drive state 1: rotate CCW when sensors 8-5 (driver side) see the line
-        //and sensors 4-1 (passengers side) do NOT see the line 
-        else if(lineArray->getSensor_8() == true && 
-                lineArray->getSensor_7() == true &&
-                lineArray->getSensor_6() == true && 
-                lineArray->getSensor_5() == true && 
-                lineArray->getSensor_4() == false && 
-                lineArray->getSensor_3() == false && 
-                lineArray->getSensor_2() == false &&
-                lineArray->getSensor_1() == false)
-                {
-                    driveState_share.put(1);
-                }
-        //drive state 2: turn left (right wheel drives at 2x the speed of left wheel)
-        //when (sensors 5 and 6) OR (sensors 6 and 7) see the line and all other sensors
-        //do NOT see the line
-        else if( (lineArray->getSensor_8() == false && 
-                lineArray->getSensor_7() == true &&
-                lineArray->getSensor_6() == true && 
-                lineArray->getSensor_5() == false && 
-                lineArray->getSensor_4() == false && 
-                lineArray->getSensor_3() == false && 
-                lineArray->getSensor_2() == false &&
-                lineArray->getSensor_1() == false) 
-                ||
-                (lineArray->getSensor_8() == false && 
-                lineArray->getSensor_7() == false &&
-                lineArray->getSensor_6() == true && 
-                lineArray->getSensor_5() == true && 
-                lineArray->getSensor_4() == false && 
-                lineArray->getSensor_3() == false && 
-                lineArray->getSensor_2() == false &&
-                lineArray->getSensor_1() == false) )
-                {
-                    driveState_share.put(2);
-                }
-        //drive state 3: turn right (left wheel drives at 2x the speed of right wheel)
-        //when (sensors 4 and 3) OR (sensors 3 and 2) see the line and all other sensors
-        //do NOT see the line
-        else if( (lineArray->getSensor_8() == false && 
-                lineArray->getSensor_7() == false &&
-                lineArray->getSensor_6() == false && 
-                lineArray->getSensor_5() == false && 
-                lineArray->getSensor_4() == true && 
-                lineArray->getSensor_3() == true && 
-                lineArray->getSensor_2() == false &&
-                lineArray->getSensor_1() == false) 
-                ||
-                (lineArray->getSensor_8() == false && 
-                lineArray->getSensor_7() == false &&
-                lineArray->getSensor_6() == false && 
-                lineArray->getSensor_5() == false && 
-                lineArray->getSensor_4() == false && 
-                lineArray->getSensor_3() == true && 
-                lineArray->getSensor_2() == true &&
-                lineArray->getSensor_1() == false) )
-                {
-                    driveState_share.put(3);
-                }
-        //drive state 4: rotate CW when sensors 4-1 (passenger side) see the line
-        //and sensors 8-5 (drivers side) do NOT see the line 
-        else if(lineArray->getSensor_8() == false && 
-                lineArray->getSensor_7() == false &&
-                lineArray->getSensor_6() == false && 
-                lineArray->getSensor_5() == false && 
-                lineArray->getSensor_4() == true && 
-                lineArray->getSensor_3() == true && 
-                lineArray->getSensor_2() == true &&
-                lineArray->getSensor_1() == true)
-                {
-                    driveState_share.put(4);
-                }        
+        // sleep until the DMA has filled a frame's worth of samples, then
+        // take a majority vote of them
+        uint8_t frame;
+        if (lineArray->getFrame (frame, 2 * IR_PERIOD_MS))
+        {
+            IR_deadline.check_in ();
+            handle_IR_frame (frame);
+        }
+    }
+#else
+    // Initialise the xLastWakeTime variable with the current time.
+    // It will be used to run the task at precise intervals
+    TickType_t xLastWakeTime = xTaskGetTickCount();
 
-        vTaskDelay(TASK_DELAY);
+    for (;;)
+    {
+        IR_array_step ();
+
+        // wait until 5 ms after this run began, so the time taken to read
+        // the sensors doesn't stretch the period
+        vTaskDelayUntil (&xLastWakeTime, IR_PERIOD_MS);
 
     }//end for: infinite loop to run during the task
+#endif
 
 }//end task: task_IR_array
 
 /** @brief   Task which gets turns CleanBot on or off from Wifi Reciever
- *  @details This task uses the ESP8266 WiFi module to determine if it is safe
- *           for the CleanBot to be running. If a WiFi signal is detected, then
- *           a value of TRUE is assigned to the wifi_to_motor_share so that the
- *           CleanBot will run. Otherwise, a value of FALSE is assigned.
- * 
+ *  @details See @c wifi_step().
  *  @param   p_params A pointer to function parameters which we don't use.
  */
 void task_wifi_reciever (void* p_params)
 {
     (void) p_params;
+    TickType_t xLastWakeTime = xTaskGetTickCount();
     for (;;)
     {
-        // call wifi reciever function and put result into share
-
-        // code that turns CleanBot On/off depending on if 
-        // signal has been sent. Send a share to drive train task 
-        // needs to be true for rest of the task to run 
-        // and LED to be on
-        
-        // will put a boolean into wifi_flag
-        
-
+        wifi_step ();
+        vTaskDelayUntil (&xLastWakeTime, WIFI_PERIOD_MS);
     }
 }
 
 /** @brief   turns LED on or off depending on the signal from the wifi reciever
- *  @details This task turns on or off a digital pin assigned to the UV light 
- *           control. For this prototype, LEDs will be used in place of UV lights
- *           as a more suitable replacement.
- *           
+ *  @details See @c led_step().
  *  @param   p_params A pointer to function parameters which we don't use.
  */
 void led_task (void* p_params)
 {
     (void) p_params;
+    led_init ();
+    TickType_t xLastWakeTime = xTaskGetTickCount();
     for (;;)
     {
-        // put boolean share into a variable
-        // see if bool is true or false
-        // if true, turn LED ON
-        // if false, turn LED OFF
-
+        led_step ();
+        vTaskDelayUntil (&xLastWakeTime, WIFI_PERIOD_MS);
     }
 }
 
-/** @brief   Reads the encoders position and puts it into queue to be sent to
- *           the motor driver task
- *  @details This task reads the magnetic encoders and determines their rate of
- *           rotation or angular velocity. The values are then put into queues 
- *           to be read by the drivetrain task which is then used for closed loop
- *           feedback control to hold steady motor speeds.
- *           
+/** @brief   Reads the encoders and publishes the odometry for the IR array
+ *           task
+ *  @details See @c encoder_step().
  *  @param   p_params A pointer to function parameters which we don't use.
  */
 void encoder_task (void* p_params)
 {
     (void) p_params;
+    encoder_init ();
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    for (;;)
+    {
+        encoder_step ();
+        vTaskDelayUntil (&xLastWakeTime, ENCODER_PERIOD_MS);
+    }
+}
+
+/** @brief   Task which prints diagnostic information on request.
+ *  @details See @c diagnostics_step().
+ *  @param   p_params A pointer to function parameters which we don't use.
+ */
+void task_diagnostics (void* p_params)
+{
+    (void) p_params;
+    diagnostics_init ();
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+
     for (;;)
     {
-        // read encoder from left motor
-        // put position into left_motor_position queue
-        // read encoder from right motor
-        // put position into left_motor_position queue
+        diagnostics_step ();
+        vTaskDelayUntil (&xLastWakeTime, DIAGNOSTICS_PERIOD_MS);
+    }
+}
 
-        // clear encoders if told to by motor driver task
+#ifdef CLEANBOT_RECORD
+/** @brief   Task which prints the recorded trace once the buffer is full.
+ *  @details See @c trace_dump_step().
+ *  @param   p_params A pointer to function parameters which we don't use.
+ */
+void task_trace_dump (void* p_params)
+{
+    (void) p_params;
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    for (;;)
+    {
+        trace_dump_step ();
+        vTaskDelayUntil (&xLastWakeTime, DIAGNOSTICS_PERIOD_MS);
     }
 }
+#endif
 
+#endif // CLEANBOT_CYCLIC_EXEC
 
-void setup() {
-  // put your setup code here, to run once:
+
+/** @brief   Arduino setup function which creates the tasks and starts the
+ *           RTOS scheduler.
+ *  @details In builds with @c CLEANBOT_CYCLIC_EXEC defined, the tasks are
+ *           set up here instead and the cyclic executive runs their step
+ *           functions from TIM15, so this function never returns.
+ */
+void setup()
+{
+    Serial.begin (SERIAL_BAUD);
+
+#ifdef CLEANBOT_CYCLIC_EXEC
+    IR_array_init ();
+    drive_train_init ();
+    encoder_init ();
+    led_init ();
+    diagnostics_init ();
+    executive.begin (TIM15);
+    executive.run ();
+#else
+    xTaskCreate (task_IR_array, "IR Array", 1024, NULL, 2, NULL);
+    xTaskCreate (task_drive_train, "Drive Train", 1024, NULL, 1, NULL);
+    xTaskCreate (task_wifi_reciever, "WiFi", 512, NULL, 1, NULL);
+    xTaskCreate (led_task, "LED", 512, NULL, 1, NULL);
+    xTaskCreate (encoder_task, "Encoders", 512, NULL, 1, NULL);
+    xTaskCreate (task_diagnostics, "Diagnostics", 1024, NULL, 1, NULL);
+#ifdef CLEANBOT_RECORD
+    xTaskCreate (task_trace_dump, "Trace", 1024, NULL, 1, NULL);
+#endif
+
+    // On STM32 targets, start the RTOS scheduler. Other targets start it
+    // automatically after setup() returns
+    #if (defined STM32L4xx || defined STM32F4xx)
+        vTaskStartScheduler ();
+    #endif
+#endif
 }
 
-/** @brief   Arduino's low-priority loop function, which we don't use.
+/** @brief   Arduino's low-priority loop function, which measures idle time.
  *  @details A non-RTOS Arduino program runs all of its continuously running
  *           code in this function after @c setup() has finished. When using
- *           FreeRTOS, @c loop() implements a low priority task on most
- *           microcontrollers, and crashes on some others, so we'll not use it.
+ *           FreeRTOS, @c loop() is called over and over by the idle task, so
+ *           it only tells the idle meter that nothing else is running. The
+ *           cyclic executive never returns from @c setup(), so there this
+ *           function isn't called and the executive measures its own idle
+ *           time.
  */
-void loop () 
+void loop ()
 {
-}
\ No newline at end of file
+    idle_meter.idle ();
+}
@@ -5,6 +5,8 @@
  *  @author Alex Haduong 
  *  @author Aris Recidoro
  *  @date 05 Nov 2020
+ *  @date 18 Oct 2026 SetPins() keeps the pins; ChangeSpeed() no longer loops
+ *        forever or writes the pins itself
  */
 
 
@@ -14,74 +16,68 @@
 #if (defined STM32L4xx || defined STM32F4xx)
     #include <STM32FreeRTOS.h>
 #endif
-#include "taskshare.h"
 #include "motor_driver.h"
+#include "drive_logic.h"
 
+/// Milliseconds between steps of the speed filter
+static const uint32_t sim_period = 50;
 
 
-/** @brief   Function which runs a motor.
- *  @details This function runs at precise interfals using @c vTaskDelayUntil() and
- *           runs a motor whose duty cycle is controlled by a
- *           power level sent from the UI task. The simulation is just a very
- *           simple implementation of a first-order filter. 
+/** @brief   Constructor which starts the motor stopped.
+ */
+Motor_Driver::Motor_Driver()
+    : PIN_MD1_IN1(0), PIN_MD1_IN2(0), sim_speed(0), sim_A(DEFAULT_SIM_A),
+      last_target(0), filter_started(false), last_step_ms(0)
+{
+}
+
+/** @brief   Function which saves the pins of a motor.
+ *  @details The pins are set up as outputs by @c MotorOutput::begin(), which
+ *           also puts the ENABLE pin's timer into PWM mode.
  *  @param   PHASE_PIN is PHASE PIN for DRV8838 Motor Carrier
  *  @param   ENABLE_PIN is ENABLE PIN for DRV8838 Motor Carrier
  */
 void Motor_Driver::SetPins(uint8_t PHASE_PIN, uint8_t ENABLE_PIN)
 {
-    uint8_t PIN_MD1_IN1 = PHASE_PIN;
-    uint8_t PIN_MD1_IN2 = ENABLE_PIN;
-    pinMode(PIN_MD1_IN2, OUTPUT);   // initializing pin 3 as a pin for output
-    pinMode(PIN_MD1_IN1, OUTPUT);   // initializing pin 5 as a pin for output
+    PIN_MD1_IN1 = PHASE_PIN;
+    PIN_MD1_IN2 = ENABLE_PIN;
 }
 
-/** @brief   Function which runs a motor.
- *  @details This function runs at precise interfals using @c vTaskDelayUntil() and
- *           runs a motor whose duty cycle is controlled by a
- *           power level sent from the UI task. The simulation is just a very
- *           simple implementation of a first-order filter. 
+/** @brief   Function which filters the speed asked for.
+ *  @details The filter is a very simple implementation of a first-order
+ *           filter which takes a step every 50 ms, measured with @c millis()
+ *           so it works with or without the RTOS, and the drive train may
+ *           call this as often as it likes. The first
+ *           call always takes a step.
  *  @param   duty_cycle_var a variable user inputs to change speed of motor
  */
-void Motor_Driver::ChangeSpeed(uint8_t duty_cycle_var)
+void Motor_Driver::ChangeSpeed(int16_t duty_cycle_var)
 {
-    float sim_speed = 1; // Variable holding the simulated motor speed
-    float sim_A = 0.99; // constant which controls the simulated time constant of the motor
-    float sim_B = 1.0 - sim_A; // constant which controls the simulated time constant of the motor
-    const TickType_t sim_period = 50;         // RTOS ticks (ms) between runs
+    last_target = duty_cycle_var;
 
-    // Initialise the xLastWakeTime variable with the current time.
-    // It will be used to run the task at precise intervals
-    TickType_t xLastWakeTime = xTaskGetTickCount();
+    uint32_t now = millis();
+    if (!filter_started || now - last_step_ms >= sim_period)
+    {
+        sim_speed = filter_speed(sim_speed, duty_cycle_var, sim_A); // Calculate the next motor speed
+        last_step_ms = now;
+        filter_started = true;
+    }
+}
 
-    for (;;)
-    {   
-       
-        if (duty_cycle_var < 0)
-        {
-            sim_speed = sim_speed * sim_A + abs(duty_cycle_var) * sim_B; // Calculate the next motor speed
-            //digitalWrite(PIN_MD1_IN1, 0);                    // setting IN1 to 0 drives motor forward
-            digitalWrite(PIN_MD1_IN1, 0);
-            // digitalWrite(PIN_MD1_IN2, 1);
-            analogWrite(PIN_MD1_IN2, (int32_t)sim_speed); // setting IN2 to duty cycle controls pwm% speed  
-        }
-        else if (duty_cycle_var == 0)
-        {
-            digitalWrite(PIN_MD1_IN1, 1);
-            analogWrite(PIN_MD1_IN2, 1);
-        }
-        else
-        {
-            sim_speed = sim_speed * sim_A + abs(duty_cycle_var) * sim_B; // Calculate the next motor speed
-            //digitalWrite(PIN_MD1_IN1, 0);                    // setting IN1 to 0 drives motor forward
-            digitalWrite(PIN_MD1_IN1, 1);
-            // digitalWrite(PIN_MD1_IN2, 1);
-            analogWrite(PIN_MD1_IN2, 255-(int32_t)sim_speed); // setting IN2 to duty cycle controls pwm% speed  
-        }
+/** @brief   Function which stops the motor without waiting for the filter.
+ */
+void Motor_Driver::Stop()
+{
+    sim_speed = 0;
+    last_target = 0;
+}
 
-        
-        // This type of delay waits until it has been the given number of RTOS
-        // ticks since the task previously began running. This prevents timing
-        // inaccuracy due to not accounting for how long the task took to run
-        vTaskDelayUntil (&xLastWakeTime, sim_period);
-    }
+/** @brief   Function which gives the filtered speed.
+ *  @details The filter only works on the size of the speed; the direction is
+ *           that of the speed last asked for.
+ *  @return  Speed from -255 to 255
+ */
+float Motor_Driver::GetOutput() const
+{
+    return last_target < 0 ? -sim_speed : sim_speed;
 }
@@ -9,6 +9,8 @@
  *  
  *  @date    12 Nov 2020 File Created
  *  @date    13 Nov 2020 Class Structure, variables, and methods created
+ *  @date    18 Oct 2026 ChangeSpeed() takes one filter step and returns; the
+ *                       pins are written by @c MotorOutput
  */
 
 
@@ -17,10 +19,11 @@
 
 #include <Arduino.h>
 
-/** @brief   Class which implements a 8 sensor IR reflectance array 
- *  @details This class creates objects for 8 sensor IR reflectance arrays,
- *           primarily of the Pololu QTR-8RC type. The class has 8 bit integers 
- *           to hold the pins on the nucleo that are used for the IR array
+/** @brief   Class which implements the speed filter of one DRV8838 motor
+ *  @details This class holds the pins on the nucleo which one motor carrier
+ *           is attatched to and the first-order filter which smooths the
+ *           speeds asked for by the drive train. The pins themselves are
+ *           driven by a @c MotorOutput, which looks after both motors.
  */
 class Motor_Driver
 {
@@ -30,9 +33,18 @@ private:
 uint8_t PIN_MD1_IN1;
 uint8_t PIN_MD1_IN2;
 
+float sim_speed;                    ///< Output of the speed filter
+float sim_A;                        ///< Filter constant, see filter_speed()
+int16_t last_target;                ///< Speed last asked for
+bool filter_started;                ///< True once the filter has taken a step
+uint32_t last_step_ms;              ///< Time of the last filter step
 
 public:
 
+/** @brief      Constructor which starts the motor stopped
+ */
+Motor_Driver();
+
 /** @brief      Constructor to make motordriver object and set the correct pins
  * 
  *  @param      PHASE_PIN  set the pin number for the phase pin 
@@ -41,11 +53,26 @@ public:
 void SetPins(uint8_t PHASE_PIN, uint8_t ENABLE_PIN);
 
 /** @brief      method to set motor speed
+ *  @details    The filter takes a step at most once every 50 ms, however
+ *              often this is called, and the new output can be read with
+ *              @c GetOutput().
  * 
- * @param       duty_cycle_var  set the speed for the motor to turn(max of 255)
+ * @param       duty_cycle_var  set the speed for the motor to turn, from
+ *                              -255 to 255
+ */
+void ChangeSpeed(int16_t duty_cycle_var);
+
+/** @brief      Stops the motor at once, without waiting for the filter
  */
-void ChangeSpeed(uint8_t duty_cycle_var);
+void Stop();
+
+/** @brief      Returns the filtered speed, from -255 to 255
+ */
+float GetOutput() const;
+
+uint8_t GetPhasePin() const { return PIN_MD1_IN1; }
+uint8_t GetEnablePin() const { return PIN_MD1_IN2; }
 
 }; //end class decleration
 
-#endif //end if: define ir_array class declaration
\ No newline at end of file
+#endif //end if: define motor driver class declaration
@@ -0,0 +1,193 @@
+/** @file   motor_output.cpp
+ *  @brief  This file contains the definition of the output stage which
+ *          drives both motor carriers through the STM32's timers.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ */
+
+#include <PrintStream.h>
+#include "motor_output.h"
+
+
+/** @brief      Constructor which chooses the PWM frequency
+ */
+MotorOutput::MotorOutput(uint32_t frequency)
+    : pwm_hz(frequency), left(), right(), running(false), writes(0),
+      skips(0)
+{
+}
+
+/** @brief      Sets up one motor's timer and pins
+ *  @details    The timer which owns the ENABLE pin is found from the core's
+ *              table of PWM pins and put into PWM mode once. Both its auto
+ *              reload and compare registers are set to use their preload
+ *              registers, so new values only take effect at an update event.
+ *
+ *  @param      channel     The motor to set up
+ *  @param      phase_pin   Arduino pin for the carrier's PHASE input
+ *  @param      enable_pin  Arduino pin for the carrier's ENABLE input
+ *  @return     False if the ENABLE pin has no PWM timer
+ */
+bool MotorOutput::begin_channel(Channel& channel, uint8_t phase_pin,
+                                uint8_t enable_pin)
+{
+    PinName pin_name = digitalPinToPinName(enable_pin);
+    TIM_TypeDef* p_instance =
+        (TIM_TypeDef*)pinmap_peripheral(pin_name, PinMap_PWM);
+    if (p_instance == NULL)
+    {
+        return false;
+    }
+    uint32_t timer_channel =
+        STM_PIN_CHANNEL(pinmap_function(pin_name, PinMap_PWM));
+
+    channel.phase_pin = phase_pin;
+    channel.p_instance = p_instance;
+    channel.p_timer = new HardwareTimer(p_instance);
+    channel.p_timer->pause();
+    channel.p_timer->setMode(timer_channel, TIMER_OUTPUT_COMPARE_PWM1,
+                             pin_name);
+    channel.p_timer->setOverflow(pwm_hz, HERTZ_FORMAT);
+    channel.p_timer->setCaptureCompare(timer_channel, 0,
+                                       TICK_COMPARE_FORMAT);
+    channel.period = channel.p_timer->getOverflow(TICK_FORMAT);
+
+    // CCR1 to CCR4 are next to each other in the register map
+    channel.p_compare = &p_instance->CCR1 + (timer_channel - 1);
+    if (timer_channel <= 2)
+    {
+        p_instance->CCMR1 |= timer_channel == 1 ? TIM_CCMR1_OC1PE
+                                                : TIM_CCMR1_OC2PE;
+    }
+    else
+    {
+        p_instance->CCMR2 |= timer_channel == 3 ? TIM_CCMR2_OC3PE
+                                                : TIM_CCMR2_OC4PE;
+    }
+    p_instance->CR1 |= TIM_CR1_ARPE;
+
+    pinMode(phase_pin, OUTPUT);
+    digitalWrite(phase_pin, HIGH);
+    channel.forward = true;
+    channel.compare = 0;
+
+    return true;
+}
+
+/** @brief      Sets up the timers and pins of both motors
+ *  @details    The motors' ENABLE pins may be on different timers. Both
+ *              timers are started from zero one after the other, so their
+ *              PWM periods start within a few clock cycles of each other.
+ */
+bool MotorOutput::begin(const Motor_Driver& left_motor,
+                        const Motor_Driver& right_motor)
+{
+    if (!begin_channel(left, left_motor.GetPhasePin(),
+                       left_motor.GetEnablePin())
+        || !begin_channel(right, right_motor.GetPhasePin(),
+                          right_motor.GetEnablePin()))
+    {
+        return false;
+    }
+    if (left.period < MOTOR_PWM_MIN_TICKS
+        || right.period < MOTOR_PWM_MIN_TICKS)
+    {
+        return false;
+    }
+
+    left.p_timer->setCount(0);
+    right.p_timer->setCount(0);
+    left.p_timer->resume();
+    right.p_timer->resume();
+
+    running = true;
+    return true;
+}
+
+/** @brief      Works out the direction and compare value for a speed
+ *  @details    PHASE high drives the motor forward and the ENABLE duty cycle
+ *              sets the speed, so a speed of 255 is a compare value of one
+ *              whole period.
+ */
+void MotorOutput::to_hardware(const Channel& channel, float speed,
+                              bool& forward, uint32_t& compare)
+{
+    forward = speed >= 0.0f;
+    float magnitude = forward ? speed : -speed;
+    if (magnitude > 255.0f)
+    {
+        magnitude = 255.0f;
+    }
+    compare = (uint32_t)(magnitude * channel.period / 255.0f + 0.5f);
+}
+
+/** @brief      Sets both motors' speeds
+ *  @details    While the compare values are written, updates are turned off
+ *              on both timers with @c UDIS, so an update event can't load
+ *              one motor's new value without the other's. They are turned
+ *              back on together and both values are loaded at the next
+ *              update event. The direction pins change straight away.
+ */
+bool MotorOutput::apply(float left_speed, float right_speed)
+{
+    if (!running)
+    {
+        return false;
+    }
+
+    bool left_forward, right_forward;
+    uint32_t left_compare, right_compare;
+    to_hardware(left, left_speed, left_forward, left_compare);
+    to_hardware(right, right_speed, right_forward, right_compare);
+
+    if (left_forward == left.forward && left_compare == left.compare
+        && right_forward == right.forward && right_compare == right.compare)
+    {
+        skips++;
+        return false;
+    }
+
+    left.p_instance->CR1 |= TIM_CR1_UDIS;
+    right.p_instance->CR1 |= TIM_CR1_UDIS;
+
+    if (left_compare != left.compare)
+    {
+        *left.p_compare = left_compare;
+        left.compare = left_compare;
+    }
+    if (right_compare != right.compare)
+    {
+        *right.p_compare = right_compare;
+        right.compare = right_compare;
+    }
+    if (left_forward != left.forward)
+    {
+        digitalWrite(left.phase_pin, left_forward ? HIGH : LOW);
+        left.forward = left_forward;
+    }
+    if (right_forward != right.forward)
+    {
+        digitalWrite(right.phase_pin, right_forward ? HIGH : LOW);
+        right.forward = right_forward;
+    }
+
+    left.p_instance->CR1 &= ~TIM_CR1_UDIS;
+    right.p_instance->CR1 &= ~TIM_CR1_UDIS;
+
+    writes++;
+    return true;
+}
+
+/** @brief      Prints how often the hardware was written and skipped
+ */
+void MotorOutput::print(Print& printer) const
+{
+    printer.printf("Motor PWM: %lu Hz, %lu steps, %lu writes, %lu unchanged",
+                   (unsigned long)pwm_hz, (unsigned long)left.period,
+                   (unsigned long)writes, (unsigned long)skips);
+    printer << endl;
+}
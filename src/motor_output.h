@@ -0,0 +1,102 @@
+/** @file   motor_output.h
+ *  @brief  This file contains the output stage which drives the PHASE and
+ *          ENABLE pins of both DRV8838 motor carriers.
+ *  @details The PWM timers are set up once, at a frequency chosen when the
+ *           output stage is made, and afterwards only the compare registers
+ *           are written. The last direction and compare value of each motor
+ *           are kept, and the hardware is only touched when one of them
+ *           changes, so the drive train can hand over its speeds as often as
+ *           it likes. Compare values go through the timers' preload
+ *           registers, so both motors change speed at the start of a PWM
+ *           period and never part way through one.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ */
+
+
+#ifndef MOTOR_OUTPUT_H
+#define MOTOR_OUTPUT_H
+
+#include <Arduino.h>
+#include "motor_driver.h"
+
+/// PWM frequency for the motors, above the range of hearing
+const uint32_t MOTOR_PWM_HZ = 20000;
+
+/// Fewest timer ticks per PWM period which give better than 8 bit resolution
+const uint32_t MOTOR_PWM_MIN_TICKS = 1024;
+
+/** @brief   Class which drives both motors' PWM and direction pins.
+ */
+class MotorOutput
+{
+private:
+
+/// Everything needed to drive one motor
+struct Channel
+{
+    uint8_t phase_pin;              ///< Arduino pin for PHASE (direction)
+    HardwareTimer* p_timer;         ///< Timer which makes the ENABLE signal
+    TIM_TypeDef* p_instance;        ///< That timer's registers
+    volatile uint32_t* p_compare;   ///< Compare register of the ENABLE pin
+    uint32_t period;                ///< Timer ticks per PWM period
+    bool forward;                   ///< Direction last written to PHASE
+    uint32_t compare;               ///< Compare value last written
+};
+
+uint32_t pwm_hz;                    ///< PWM frequency
+Channel left;                       ///< The left motor
+Channel right;                      ///< The right motor
+bool running;                       ///< True once begin() has succeeded
+uint32_t writes;                    ///< Times the hardware was written
+uint32_t skips;                     ///< Times nothing had changed
+
+// Sets up one motor's timer and pins
+bool begin_channel(Channel& channel, uint8_t phase_pin, uint8_t enable_pin);
+
+// Works out the direction and compare value for a speed
+static void to_hardware(const Channel& channel, float speed, bool& forward,
+                        uint32_t& compare);
+
+public:
+
+/** @brief      Constructor which chooses the PWM frequency
+ *  @param      frequency   PWM frequency in Hz
+ */
+MotorOutput(uint32_t frequency = MOTOR_PWM_HZ);
+
+/** @brief      Sets up the timers and pins of both motors
+ *  @details    Each motor driver must have had its pins set first.
+ *  @return     False if an ENABLE pin has no PWM timer, or if the frequency
+ *              leaves fewer than @c MOTOR_PWM_MIN_TICKS steps of speed
+ */
+bool begin(const Motor_Driver& left_motor, const Motor_Driver& right_motor);
+
+/** @brief      Sets both motors' speeds
+ *  @details    Speeds run from -255 to 255 as in @c drive_speeds(), but
+ *              fractions are kept, so a filtered speed changes smoothly.
+ *              The hardware is only written if the direction or compare
+ *              value of a motor is different from what was last written.
+ *
+ *  @param      left_speed  Speed of the left motor
+ *  @param      right_speed Speed of the right motor
+ *  @return     True if the hardware was written
+ */
+bool apply(float left_speed, float right_speed);
+
+/** @brief      Returns the number of timer ticks in one PWM period
+ *  @details    This is the number of steps between stopped and full speed.
+ */
+uint32_t get_resolution() const { return left.period; }
+
+/** @brief      Prints how often the hardware was written and skipped
+ */
+void print(Print& printer) const;
+
+}; //end class MotorOutput
+
+#endif //end if: define motor output declarations
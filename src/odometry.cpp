@@ -0,0 +1,36 @@
+/** @file   odometry.cpp
+ *  @brief  This file contains the definition of the dead reckoning which
+ *          turns encoder counts into the CleanBot's position.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ */
+
+#include <math.h>
+#include "odometry.h"
+
+/** @brief      Moves the odometry on to a new pair of encoder counts
+ *  @details    The position is moved along the chord of the arc, at the
+ *              heading halfway through the turn.
+ */
+void update_odometry(Odometry& odometry, int32_t left_count,
+                     int32_t right_count, const OdometryParams& params)
+{
+    float left_mm = (left_count - odometry.left_count) * params.mm_per_count;
+    float right_mm = (right_count - odometry.right_count)
+                     * params.mm_per_count;
+    odometry.left_count = left_count;
+    odometry.right_count = right_count;
+
+    float moved = 0.5f * (left_mm + right_mm);
+    float turned = (right_mm - left_mm) / params.wheel_base_mm;
+    float middle = odometry.heading + 0.5f * turned;
+
+    odometry.x_mm += moved * cosf(middle);
+    odometry.y_mm += moved * sinf(middle);
+    odometry.heading += turned;
+    odometry.distance_mm += fabsf(moved);
+}
@@ -0,0 +1,64 @@
+/** @file   odometry.h
+ *  @brief  This file contains the dead reckoning which turns the encoder
+ *          counts of both wheels into the CleanBot's position, heading and
+ *          distance travelled.
+ *  @details It works from the encoder counts alone, not the encoders, so
+ *           the replay tool can rebuild the odometry from the encoder
+ *           records of a trace, and the simulated robots keep theirs the
+ *           same way as the firmware does.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ */
+
+
+#ifndef ODOMETRY_H
+#define ODOMETRY_H
+
+#include <stdint.h>
+
+/** @brief   Size of the wheels and encoders.
+ *  @details The defaults are for 42 mm wheels with 450 counts per turn,
+ *           140 mm apart.
+ */
+struct OdometryParams
+{
+    float mm_per_count = 0.2932f;   ///< Distance a wheel rolls per count
+    float wheel_base_mm = 140.0f;   ///< Distance between the wheels
+};
+
+/** @brief   Where the CleanBot is, worked out from its encoder counts.
+ *  @details The position and heading are measured from where the CleanBot
+ *           was when the counts were last zero, with x straight ahead and
+ *           positive headings to the left (counter clockwise).
+ */
+struct Odometry
+{
+    int32_t left_count;             ///< Left encoder count last used
+    int32_t right_count;            ///< Right encoder count last used
+    float x_mm;                     ///< Position of the middle of the axle
+    float y_mm;                     ///< Position of the middle of the axle
+    float heading;                  ///< Direction of travel in radians,
+                                    ///< not wrapped, so it counts whole turns
+    float distance_mm;              ///< Path length driven, never decreasing
+};
+
+/** @brief      Moves the odometry on to a new pair of encoder counts
+ *  @details    The robot is taken to have moved along an arc since the last
+ *              update, which is close enough when updates come every few
+ *              millimeters. The distance is the length of the path the
+ *              middle of the axle took, counted the same way whether the
+ *              robot drove forward or backward.
+ *
+ *  @param      odometry    Position from the last update, updated
+ *  @param      left_count  Left encoder count now
+ *  @param      right_count Right encoder count now
+ *  @param      params      Size of the wheels and encoders
+ */
+void update_odometry(Odometry& odometry, int32_t left_count,
+                     int32_t right_count, const OdometryParams& params);
+
+#endif //end if: define odometry declarations
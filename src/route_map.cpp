@@ -0,0 +1,414 @@
+/** @file   route_map.cpp
+ *  @brief  This file contains the definitions of the route map which learns
+ *          a taped route and looks ahead along it.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ *  @date   18 Oct 2026     Route changes found over a sliding window of bins
+ */
+
+#include <math.h>
+#include "route_map.h"
+
+/// A whole turn, in radians
+static const float TWO_PI = 6.2831853f;
+
+/// How far past its nearest approach to the start a lap is taken to be over
+static const float CLOSE_PASSED_MM = 20.0f;
+
+/// Bins either side of the current one searched for a matching event
+static const int8_t SYNC_BINS = 4;
+
+
+/** @brief      Returns true for the kinds of line worth putting in the map
+ *  @details    Corners and intersections are at fixed places on the route;
+ *              single and wide pieces of line and lost frames are not.
+ */
+static bool is_landmark(LineKind kind)
+{
+    return kind == LINE_CORNER_LEFT || kind == LINE_CORNER_RIGHT
+           || kind == LINE_CROSSING;
+}
+
+/** @brief      Constructor which makes an empty map
+ */
+RouteMap::RouteMap(const RouteParams& route_params)
+    : params(route_params), mode(ROUTE_LEARNING), started(false),
+      lap_bins(0), bin(0), lap_start_mm(0.0f), bin_start_heading(0.0f),
+      bin_event(LINE_NONE), last_kind(LINE_NONE), start(), closing(false),
+      closest_mm(0.0f), closest(), bins_driven(0), lap_shift(0),
+      mismatch_history(0), mismatches(0), laps(0), relearns(0), resyncs(0),
+      overflows(0)
+{
+}
+
+/** @brief      Starts learning a new lap from where the robot is
+ *  @details    Whatever was in the map is thrown away and the robot drives
+ *              slowly until the new lap closes.
+ */
+void RouteMap::start_lap(const Odometry& odometry)
+{
+    mode = ROUTE_LEARNING;
+    lap_bins = 0;
+    bin = 0;
+    lap_start_mm = odometry.distance_mm;
+    bin_start_heading = odometry.heading;
+    bin_event = LINE_NONE;
+    start = odometry;
+    closing = false;
+    bins_driven = 0;
+    lap_shift = 0;
+    mismatch_history = 0;
+    mismatches = 0;
+}
+
+/** @brief      Adds up the stored curvature of the bins from one bin on
+ *  @param      first   First bin of the window; may be past the lap's end
+ */
+int16_t RouteMap::stored_window(uint16_t first) const
+{
+    int16_t sum = 0;
+    for (uint8_t index = 0; index < ROUTE_WINDOW_BINS; index++)
+    {
+        sum += bins[(first + index) % lap_bins].curvature;
+    }
+    return sum;
+}
+
+/** @brief      Adds up the stored curvature of the window of bins ending
+ *              at one bin
+ *  @param      last    Last bin of the window; may be past the lap's end or,
+ *                      early in a lap, before its start
+ */
+int16_t RouteMap::window_ending(int32_t last) const
+{
+    int32_t first = last + 1 - ROUTE_WINDOW_BINS;
+    while (first < 0)
+    {
+        first += lap_bins;
+    }
+    return stored_window((uint16_t)(first % lap_bins));
+}
+
+/** @brief      Moves to a nearby bin whose window of turn matches better
+ *  @details    In a curve the turn over a window changes along the route as
+ *              the window moves into and out of the curve, so the bin at
+ *              which the map has the turn the robot has just made shows
+ *              where the robot really is. The robot's path weaves and is a
+ *              little longer or shorter on every lap, and this keeps those
+ *              differences from adding up. Bins up to twice @c SYNC_BINS
+ *              either way are tried; the bin is only changed if one of them
+ *              matches better by a quarter of the mismatch limit, so the
+ *              weaving on a straight doesn't move it. The bin may move no
+ *              more than @c lap_window_mm in one lap, so a longer or shorter
+ *              straight still shows up as a mismatch.
+ *
+ *  @param      measured    Turn over the last window of bins, in curvature
+ *                          units times bins
+ *  @param      error       Difference from the map at the current bin
+ *  @return     Difference from the map at the bin now being driven
+ */
+float RouteMap::match_heading(float measured, float error)
+{
+    float margin = 0.25f * params.mismatch_heading * ROUTE_CURVE_SCALE
+                   / (ROUTE_BIN_MM / 1000.0f);
+    float best = error;
+    int8_t best_offset = 0;
+    const int16_t shift_limit = params.lap_window_mm / ROUTE_BIN_MM;
+    for (int8_t offset = -2 * SYNC_BINS; offset <= 2 * SYNC_BINS; offset++)
+    {
+        if (offset == 0 || (int32_t)bin + offset < 0
+            || lap_shift + offset > shift_limit
+            || lap_shift + offset < -shift_limit)
+        {
+            continue;
+        }
+        float differs = fabsf(measured - window_ending((int32_t)bin + offset));
+        if (differs < best)
+        {
+            best = differs;
+            best_offset = offset;
+        }
+    }
+
+    if (best_offset == 0 || best > error - margin)
+    {
+        return error;
+    }
+    bin += best_offset;
+    lap_shift += best_offset;
+    lap_start_mm -= best_offset * (float)ROUTE_BIN_MM;
+    resyncs++;
+    return best;
+}
+
+/** @brief      Records or checks the bin which has just been driven through
+ *  @details    The heading at the end of every bin is kept for the last
+ *              @c ROUTE_WINDOW_BINS bins. While learning, the bin is stored.
+ *              While following, the heading turned over the last window of
+ *              bins is compared with the stored curvature of the same window
+ *              of the map, and the result is shifted into a history of the
+ *              last 32 bins, about 0.8 m of route. When too many of those
+ *              differ the route has changed and is learned again. Nothing
+ *              is compared until a whole window has been driven since the
+ *              map was started over.
+ *  @return     False if the lap was started over from here
+ */
+bool RouteMap::finish_bin(const Odometry& odometry, int8_t curvature)
+{
+    float window_start = window_headings[bins_driven % ROUTE_WINDOW_BINS];
+    window_headings[bins_driven % ROUTE_WINDOW_BINS] = odometry.heading;
+    bins_driven++;
+
+    if (mode == ROUTE_LEARNING)
+    {
+        if (bin >= ROUTE_BINS)
+        {
+            // The route is longer than the map; start again from here
+            overflows++;
+            start_lap(odometry);
+            return false;
+        }
+        bins[bin].curvature = curvature;
+        bins[bin].event = bin_event;
+    }
+    else if (bins_driven > ROUTE_WINDOW_BINS)
+    {
+        float measured = (odometry.heading - window_start)
+                         * ROUTE_CURVE_SCALE / (ROUTE_BIN_MM / 1000.0f);
+        float limit = params.mismatch_heading * ROUTE_CURVE_SCALE
+                      / (ROUTE_BIN_MM / 1000.0f);
+        float error = fabsf(measured - window_ending(bin));
+        if (error > 0.5f * limit)
+        {
+            error = match_heading(measured, error);
+        }
+        bool differs = error > limit;
+
+        mismatches += (differs ? 1 : 0) - (mismatch_history >> 31);
+        mismatch_history = (mismatch_history << 1) | (differs ? 1 : 0);
+        if (mismatches > params.mismatch_limit)
+        {
+            relearns++;
+            start_lap(odometry);
+            return false;
+        }
+    }
+
+    bin++;
+    bin_event = LINE_NONE;
+    return true;
+}
+
+/** @brief      Ends the lap if the robot has come back to the start
+ *  @details    Once the robot is within @c close_radius_mm of the lap's
+ *              start and pointing the same way, the nearest approach is
+ *              tracked, and the lap ends there once the robot has moved on.
+ *              A learned lap must end within @c lap_window_mm of its learned
+ *              length; if it runs on further than that, the route has
+ *              changed. The bins driven since the nearest approach are the
+ *              start of the next lap.
+ */
+void RouteMap::check_lap_end(const Odometry& odometry)
+{
+    float lap_mm = odometry.distance_mm - lap_start_mm;
+    float learned_mm = (float)lap_bins * ROUTE_BIN_MM;
+    if (mode == ROUTE_LEARNING ? lap_mm < params.min_lap_mm
+                               : lap_mm < learned_mm - params.lap_window_mm)
+    {
+        return;
+    }
+    if (mode == ROUTE_FOLLOWING && !closing
+        && lap_mm > learned_mm + params.lap_window_mm)
+    {
+        relearns++;
+        start_lap(odometry);
+        return;
+    }
+
+    float gap = hypotf(odometry.x_mm - start.x_mm,
+                       odometry.y_mm - start.y_mm);
+    float turn = fabsf(remainderf(odometry.heading - start.heading, TWO_PI));
+    bool near = gap < params.close_radius_mm && turn < params.close_heading;
+    if (near && (!closing || gap < closest_mm))
+    {
+        closing = true;
+        closest_mm = gap;
+        closest = odometry;
+        return;
+    }
+    if (!closing || (near && gap < closest_mm + CLOSE_PASSED_MM))
+    {
+        return;
+    }
+
+    // The robot has gone past the start; the lap ended at the nearest point
+    if (mode == ROUTE_LEARNING)
+    {
+        uint16_t closed_bins = (uint16_t)((closest.distance_mm - lap_start_mm)
+                                          / ROUTE_BIN_MM + 0.5f);
+        lap_bins = closed_bins < bin ? closed_bins : bin;
+        mode = ROUTE_FOLLOWING;
+    }
+    laps++;
+    closing = false;
+    start = closest;
+    lap_start_mm = closest.distance_mm;
+    bin = (uint16_t)((odometry.distance_mm - lap_start_mm) / ROUTE_BIN_MM);
+    lap_shift = 0;
+}
+
+/** @brief      Lines the distance up with the map when a landmark is seen
+ *  @details    The nearest bin with the same landmark, within a few bins
+ *              either way, is taken to be where the robot really is.
+ */
+void RouteMap::resync(LineKind kind)
+{
+    for (int8_t offset = 0; offset <= SYNC_BINS; offset++)
+    {
+        for (int8_t sign = 1; sign >= -1; sign -= 2)
+        {
+            int32_t index = (int32_t)bin + sign * offset;
+            if (index < 0 || (offset == 0 && sign < 0))
+            {
+                continue;
+            }
+            if (bins[index % lap_bins].event != kind)
+            {
+                continue;
+            }
+            if (offset != 0)
+            {
+                lap_start_mm -= sign * offset * (float)ROUTE_BIN_MM;
+                bin = (uint16_t)index;
+                resyncs++;
+            }
+            return;
+        }
+    }
+}
+
+/** @brief      Gives the map the latest odometry and kind of line
+ *  @details    When the robot has moved on to a new bin, the heading change
+ *              since the last bin began gives the curvature of the bins
+ *              driven through. Updates come every few millimeters, so this
+ *              is almost always one bin at a time.
+ */
+void RouteMap::update(const Odometry& odometry, LineKind kind)
+{
+    if (!started)
+    {
+        started = true;
+        start_lap(odometry);
+        return;
+    }
+
+    // A landmark is placed where it first comes into view
+    if (is_landmark(kind) && kind != last_kind)
+    {
+        if (bin_event == LINE_NONE)
+        {
+            bin_event = kind;
+        }
+        if (mode == ROUTE_FOLLOWING)
+        {
+            resync(kind);
+        }
+    }
+    last_kind = kind;
+
+    uint32_t reached = (uint32_t)((odometry.distance_mm - lap_start_mm)
+                                  / ROUTE_BIN_MM);
+    if (reached > bin)
+    {
+        float turned = odometry.heading - bin_start_heading;
+        float meters = (reached - bin) * ROUTE_BIN_MM / 1000.0f;
+        float scaled = turned / meters * ROUTE_CURVE_SCALE;
+        int8_t curvature = (int8_t)(scaled > 127.0f ? 127
+                                    : scaled < -127.0f ? -127
+                                    : lroundf(scaled));
+        bin_start_heading = odometry.heading;
+
+        // Finishing a bin may move to another one to line up with the map,
+        // so count the bins driven rather than running up to reached
+        for (uint32_t driven = reached - bin; driven > 0; driven--)
+        {
+            if (!finish_bin(odometry, curvature))
+            {
+                return;
+            }
+        }
+    }
+
+    check_lap_end(odometry);
+}
+
+/** @brief      Looks ahead along the learned route
+ *  @details    Each window of bins from the current one to the look ahead
+ *              distance is checked in order, so the advice comes from the
+ *              nearest curve. Steering is only suggested as a curve begins;
+ *              once the robot is in it, the line tracker follows it better.
+ */
+RouteAdvice RouteMap::advise() const
+{
+    RouteAdvice advice = {100, 100, 0};
+    if (mode != ROUTE_FOLLOWING)
+    {
+        advice.cruise_percent = params.learn_percent;
+        return advice;
+    }
+
+    const float threshold = params.curve_threshold * ROUTE_CURVE_SCALE
+                            * ROUTE_WINDOW_BINS;
+    uint16_t lookahead = params.lookahead_mm / ROUTE_BIN_MM;
+    uint16_t steer_ahead = params.steer_ahead_mm / ROUTE_BIN_MM;
+    for (uint16_t ahead = 0; ahead <= lookahead; ahead++)
+    {
+        int16_t sum = stored_window((uint16_t)(bin + ahead));
+        if (sum >= threshold || sum <= -threshold)
+        {
+            advice.cruise_percent = params.brake_percent;
+            if (ahead > 0 && ahead <= steer_ahead)
+            {
+                advice.steer = sum > 0 ? 1 : -1;
+            }
+            break;
+        }
+    }
+    return advice;
+}
+
+
+/** @brief      Chooses the wheel speeds for a drive state with the route
+ *              map's advice
+ */
+uint8_t route_drive(const RouteAdvice& advice, uint8_t drive_state,
+                    const DriveParams& params, int16_t& left, int16_t& right)
+{
+    if (drive_state == 0 && advice.steer != 0)
+    {
+        drive_state = advice.steer > 0 ? 2 : 3;
+    }
+
+    DriveParams held = params;
+    if (advice.cruise_percent < 100)
+    {
+        held.cruise_percent = (uint8_t)((uint16_t)params.cruise_percent
+                                        * advice.cruise_percent / 100);
+        held.turn_percent = (uint8_t)((uint16_t)params.turn_percent
+                                      * advice.cruise_percent / 100);
+    }
+
+    left = 0;
+    right = 0;
+    drive_speeds(drive_state, held, left, right);
+    if (advice.speed_percent < 100)
+    {
+        left = (int16_t)((int32_t)left * advice.speed_percent / 100);
+        right = (int16_t)((int32_t)right * advice.speed_percent / 100);
+    }
+    return drive_state;
+}
@@ -0,0 +1,235 @@
+/** @file   route_map.h
+ *  @brief  This file contains a memory of the taped route, learned on the
+ *          first lap and used on later laps to slow down and start turning
+ *          before each curve is reached.
+ *  @details The route is cut into bins of @c ROUTE_BIN_MM of path length, as
+ *           measured by odometry. On the first lap, each bin records how
+ *           sharply the CleanBot turned while driving through it and any
+ *           intersection or corner the IR array saw there. The lap ends when
+ *           the CleanBot comes back to where it started, pointing the same
+ *           way. The first lap is driven slowly. On later laps the bins ahead
+ *           show where the next curve is, so the speed can be brought down
+ *           and the turn begun before each curve, instead of after the IR
+ *           array has already run off the line. The aim is to keep the
+ *           CleanBot closer to the tape, and so the lamp over the floor it
+ *           is meant to dose, rather than to drive a lap faster; the map
+ *           never asks for more than the cruise speed.
+ *
+ *           As each bin is driven, the heading turned over the last
+ *           @c ROUTE_WINDOW_BINS bins is compared with the turn the map has
+ *           for the same stretch of route. The line tracker weaves from side
+ *           to side on a straight, so single bins' curvature doesn't match
+ *           from lap to lap, but over a window of bins the weaving mostly
+ *           cancels while a missing or extra curve doesn't. Only the window
+ *           is compared, never the heading since the lap began, so drift
+ *           and weaving early in the lap can't build up into a mismatch
+ *           later. If too many recent bins disagree with the map, or the lap
+ *           doesn't close where it should, the route has changed and the map
+ *           is learned again from where the CleanBot is. Intersections
+ *           and corners seen near where the map has them pull the distance
+ *           back into line, so errors in the odometry don't build up.
+ *
+ *           The bins are a fixed size array inside the map, so no heap
+ *           memory is used, and a route of up to 12.8 m fits in 1 KB. The
+ *           map is handed odometry and kinds of line rather than reading
+ *           any sensors, so @c route_sim can try it over many simulated
+ *           laps, and a change to it can be checked before it goes on the
+ *           robot.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ *  @date    18 Oct 2026 Route changes found from the turn over a sliding
+ *                       window of bins; the learning lap and curves only
+ *                       limit the forward speeds
+ */
+
+
+#ifndef ROUTE_MAP_H
+#define ROUTE_MAP_H
+
+#include <stdint.h>
+#include "drive_logic.h"
+#include "line_features.h"
+#include "odometry.h"
+
+/// Number of bins in the map, which sets the longest route it can learn
+const uint16_t ROUTE_BINS = 512;
+
+/// Length of path which each bin covers, in millimeters
+const uint16_t ROUTE_BIN_MM = 25;
+
+/// Bins added together when looking for curves, to smooth out the small
+/// turns the line tracker makes on a straight
+const uint8_t ROUTE_WINDOW_BINS = 12;
+
+/// Stored curvature units per radian per meter of path
+const float ROUTE_CURVE_SCALE = 8.0f;
+
+/** @brief   What was recorded about one bin of the route.
+ */
+struct RouteBin
+{
+    int8_t curvature;               ///< Heading change per meter, scaled by
+                                    ///< ROUTE_CURVE_SCALE; positive is left
+    LineKind event;                 ///< Corner or intersection seen, if any
+};
+
+/// Whether the map is being learned or used
+enum RouteMode : uint8_t
+{
+    ROUTE_LEARNING = 0,             ///< Recording a lap; driving slowly
+    ROUTE_FOLLOWING = 1             ///< Lap recorded; anticipating curves
+};
+
+/** @brief   Tunable settings for learning and using the route map.
+ */
+struct RouteParams
+{
+    uint16_t lookahead_mm = 100;    ///< Slow down this far before a curve
+    uint16_t steer_ahead_mm = 25;   ///< Start turning this far before it
+    float curve_threshold = 1.2f;   ///< Radians per meter which is a curve
+    uint8_t brake_percent = 80;     ///< Cruise speed kept through curves
+    uint8_t learn_percent = 60;     ///< Cruise speed while the map is learned
+    uint16_t min_lap_mm = 1000;     ///< Shortest route which can be a lap
+    uint16_t close_radius_mm = 150; ///< How near the start a lap must end
+    float close_heading = 0.5f;     ///< Heading error allowed there, radians
+    uint16_t lap_window_mm = 300;   ///< How far from the learned length a
+                                    ///< later lap may end
+    float mismatch_heading = 0.8f;  ///< Radians by which the turn over a
+                                    ///< window may differ from the map's
+    uint8_t mismatch_limit = 12;    ///< Differing bins, of the last 32, at
+                                    ///< which the route has changed
+};
+
+/** @brief   What the route map suggests for the next frame.
+ */
+struct RouteAdvice
+{
+    uint8_t speed_percent;          ///< Percentage of every speed to use
+    uint8_t cruise_percent;         ///< Percentage of the forward speeds to
+                                    ///< use; spins are left alone
+    int8_t steer;                   ///< 1 to turn left, -1 right, 0 either
+};
+
+/** @brief   Class which learns a route and looks ahead along it.
+ */
+class RouteMap
+{
+private:
+
+RouteParams params;                 ///< Tunable settings
+RouteBin bins[ROUTE_BINS];          ///< The route, one entry per bin
+RouteMode mode;                     ///< Learning or following
+bool started;                       ///< True once the first update came
+uint16_t lap_bins;                  ///< Number of bins in the learned lap
+uint16_t bin;                       ///< Bin being driven through now
+float lap_start_mm;                 ///< Odometry distance at the lap start
+float bin_start_heading;            ///< Heading when this bin began
+LineKind bin_event;                 ///< Corner or crossing seen in this bin
+LineKind last_kind;                 ///< Kind of line in the last frame
+Odometry start;                     ///< Position where the lap began
+bool closing;                       ///< True while near the lap's start
+float closest_mm;                   ///< Nearest approach to the start so far
+Odometry closest;                   ///< Position at the nearest approach
+float window_headings[ROUTE_WINDOW_BINS];   ///< Heading at the end of
+                                    ///< each of the last bins driven
+uint16_t bins_driven;               ///< Bins driven since the lap began
+int16_t lap_shift;                  ///< Bins moved by heading matches this lap
+uint32_t mismatch_history;          ///< One bit per bin, set if it differed
+uint8_t mismatches;                 ///< Bits set in mismatch_history
+uint32_t laps;                      ///< Laps completed
+uint32_t relearns;                  ///< Times the route changed
+uint32_t resyncs;                   ///< Times the distance was corrected
+uint32_t overflows;                 ///< Laps too long to fit in the map
+
+// Starts learning a new lap from where the robot is
+void start_lap(const Odometry& odometry);
+
+// Records or checks the bin which has just been driven through
+bool finish_bin(const Odometry& odometry, int8_t curvature);
+
+// Ends the lap if the robot has come back to the start
+void check_lap_end(const Odometry& odometry);
+
+// Lines the distance up with the map when a corner or crossing is seen
+void resync(LineKind kind);
+
+// Moves to a nearby bin whose window of turn matches better
+float match_heading(float measured, float error);
+
+// Adds up the stored curvature of the bins from one bin on
+int16_t stored_window(uint16_t first) const;
+
+// Adds up the stored curvature of the window of bins ending at one bin
+int16_t window_ending(int32_t last) const;
+
+public:
+
+/** @brief      Constructor which makes an empty map
+ *  @param      route_params Tunable settings
+ */
+RouteMap(const RouteParams& route_params = RouteParams());
+
+/** @brief      Gives the map the latest odometry and kind of line
+ *  @details    Call once per IR frame. The first call marks the start of
+ *              the first lap.
+ *
+ *  @param      odometry    Position of the CleanBot
+ *  @param      kind        Kind of line seen in the latest frame
+ */
+void update(const Odometry& odometry, LineKind kind);
+
+/** @brief      Looks ahead along the learned route
+ *  @details    While the map is being learned nothing is known about the
+ *              curves ahead, so the whole lap is driven with the cruise
+ *              speed held to @c learn_percent and no steering. Only the
+ *              forward speeds are held down, so the spins the drive logic
+ *              uses to find the line again are as strong as ever. On
+ *              later laps, a curve within the look ahead distance brings the
+ *              cruise speed down to @c brake_percent, a curve just ahead
+ *              suggests turning toward it, and the straights are driven at
+ *              the full cruise speed.
+ */
+RouteAdvice advise() const;
+
+RouteMode get_mode() const { return mode; }
+uint32_t get_laps() const { return laps; }
+uint32_t get_relearns() const { return relearns; }
+uint32_t get_resyncs() const { return resyncs; }
+uint32_t get_overflows() const { return overflows; }
+
+/** @brief      Returns the length of the learned lap, or zero if none
+ */
+uint32_t get_lap_mm() const
+{
+    return mode == ROUTE_FOLLOWING ? (uint32_t)lap_bins * ROUTE_BIN_MM : 0;
+}
+
+}; //end class RouteMap
+
+
+/** @brief      Chooses the wheel speeds for a drive state with the route
+ *              map's advice
+ *  @details    If the line tracker wants to drive straight and the map says
+ *              a curve starts just ahead, the turn toward it is used instead.
+ *              Any other drive state is kept, since the IR array seeing the
+ *              line off to one side always wins over the map. The cruise and
+ *              turn speeds are both held to @c cruise_percent of their usual
+ *              values, so a turn still curves as tightly as it would at full
+ *              speed, while spins are left alone; then every speed is scaled
+ *              by @c speed_percent.
+ *
+ *  @param      advice      Advice from RouteMap::advise()
+ *  @param      drive_state Drive state from track_line()
+ *  @param      params      Speeds to use for each kind of motion
+ *  @param      left        Set to the speed for the left wheel
+ *  @param      right       Set to the speed for the right wheel
+ *  @return     The drive state the speeds were chosen for
+ */
+uint8_t route_drive(const RouteAdvice& advice, uint8_t drive_state,
+                    const DriveParams& params, int16_t& left, int16_t& right);
+
+#endif //end if: define route map declarations
@@ -14,6 +14,12 @@
  *  @date 2014-Oct-18 JRR Added linked list of all shares for tracking and 
  *        debugging
  *  @date 2020-Oct-10 JRR Made compatible with Arduino, class name to @c Share
+ *  @date 2026-Oct-18 Shares keep access counts and critical section times;
+ *        @c print_in_list() no longer calls the next share recursively
+ *  @date 2026-Oct-18 Critical sections use @c SHARE_ENTER_CRITICAL() so
+ *        they compile away in the cyclic executive build
+ *  @date 2026-Oct-18 @c ISR_put() and @c ISR_get() use an ISR critical
+ *        section, since interrupts can be nested
  *
  *  @copyright This file is copyright 2014 -- 2019 by JR Ridgely and released 
  *    under the Lesser GNU Public License, version 2. It intended for 
@@ -35,8 +41,7 @@
 #ifndef _TASKSHARE_H_
 #define _TASKSHARE_H_
 
-//#include "baseshare.h"                      // Base class for shared data items
-//#include "FreeRTOS.h"                       // Main header for FreeRTOS
+#include "baseshare.h"                      // Base class for shared data items
 
 
 /** @brief   Class for data to be shared in a thread-safe manner between tasks.
@@ -140,9 +145,11 @@ template <class DataType> class Share : public BaseShare
          */
         DataType& operator ++ (void)
         {
-            portENTER_CRITICAL ();
+            SHARE_ENTER_CRITICAL ();
+            uint32_t start = share_cycle_count ();
             the_data++;
-            portEXIT_CRITICAL ();
+            count_put (start);
+            SHARE_EXIT_CRITICAL ();
 
             return (the_data);
         }
@@ -153,9 +160,11 @@ template <class DataType> class Share : public BaseShare
         DataType operator ++ (int)
         {
             DataType result = the_data;
-            portENTER_CRITICAL ();
+            SHARE_ENTER_CRITICAL ();
+            uint32_t start = share_cycle_count ();
             the_data++;
-            portEXIT_CRITICAL ();
+            count_put (start);
+            SHARE_EXIT_CRITICAL ();
 
             return (result);
         }
@@ -170,9 +179,11 @@ template <class DataType> class Share : public BaseShare
          */
         DataType& operator -- (void)
         {
-            portENTER_CRITICAL ();
+            SHARE_ENTER_CRITICAL ();
+            uint32_t start = share_cycle_count ();
             the_data--;
-            portEXIT_CRITICAL ();
+            count_put (start);
+            SHARE_EXIT_CRITICAL ();
 
             return (the_data); //// *this);  The BUG
         }
@@ -183,9 +194,11 @@ template <class DataType> class Share : public BaseShare
         DataType operator -- (int)
         {
             DataType result = the_data;
-            portENTER_CRITICAL ();
+            SHARE_ENTER_CRITICAL ();
+            uint32_t start = share_cycle_count ();
             the_data--;
-            portEXIT_CRITICAL ();
+            count_put (start);
+            SHARE_EXIT_CRITICAL ();
 
             return (result);
         }
@@ -201,31 +214,39 @@ template <class DataType> class Share : public BaseShare
  *           function call, which involves pushing the program counter on the 
  *           stack, pushing parameters, jumping, making space for local 
  *           variables, jumping back and popping the program counter, @e etc.
+ *           The write is counted and the time spent in the critical 
+ *           section is measured for the share's statistics.
  *  @param   new_data The data which is to be written
  */
 
 template <class DataType>
 inline void Share<DataType>::put (DataType new_data)
 {
-    portENTER_CRITICAL ();
+    SHARE_ENTER_CRITICAL ();
+    uint32_t start = share_cycle_count ();
     the_data = new_data;
-    portEXIT_CRITICAL ();
+    count_put (start);
+    SHARE_EXIT_CRITICAL ();
 }
 
 
 /** @brief   Put data into the shared data item from within an ISR.
  *  @details This method writes data from an ISR into the shared data item. It
  *           must only be called from within an interrupt, not a normal task. 
- *           This is because critical section protection isn't used here, which
- *           is OK, assuming that an interrupt can't be interrupted by another 
- *           interrupt, which is the case on most small microcontrollers. 
+ *           The STM32's interrupts can be nested, so the write is done in an
+ *           ISR critical section; otherwise an interrupt of higher priority
+ *           which used the same share could damage the data or statistics.
  *  @param   new_data The data which is to be written into the shared data item
  */
 
 template <class DataType>
 void Share<DataType>::ISR_put (DataType new_data)
 {
+    SHARE_ENTER_CRITICAL_FROM_ISR ();
+    uint32_t start = share_cycle_count ();
     the_data = new_data;
+    ISR_count_put (start);
+    SHARE_EXIT_CRITICAL_FROM_ISR ();
 }
 
 
@@ -242,51 +263,53 @@ template <class DataType>
 void Share<DataType>::get (DataType& recv_data)
 {
     // Copy the data from the queue into the receiving variable
-    portENTER_CRITICAL ();
+    SHARE_ENTER_CRITICAL ();
+    uint32_t start = share_cycle_count ();
     recv_data = the_data;
-    portEXIT_CRITICAL ();
+    count_get (start);
+    SHARE_EXIT_CRITICAL ();
 }
 
 
 /** @brief   Read data from the shared data item, from within an ISR.
  *  @details This method is used to enable code within an ISR to read data from
  *           the shared data item. It must only be called from within an 
- *           interrupt service routine, not a normal task. This is because 
- *           critical section protection isn't used here, which is OK, assuming
- *           that an interrupt can't be interrupted by another interrupt, which
- *           is the case on most small microcontrollers. 
+ *           interrupt service routine, not a normal task. As in @c ISR_put(),
+ *           an ISR critical section keeps a nested interrupt from changing
+ *           the data or statistics part way through. 
  *  @param   recv_data A reference to the variable in which to put received
  *           data
  */
 template <class DataType>
 void Share<DataType>::ISR_get (DataType& recv_data)
 {
+    SHARE_ENTER_CRITICAL_FROM_ISR ();
+    uint32_t start = share_cycle_count ();
     recv_data = the_data;
+    count_get (start);
+    SHARE_EXIT_CRITICAL_FROM_ISR ();
 }
 
 
-/** @brief   Print the name and type (share) of this data item.
- *  @details This method prints the share's name and a word indicating that it
- *           is a shared data item, as opposed to a queue, formatted to match
- *           similar printouts from other task shares such as queues. After
- *           printing this share's information, it looks in the linked list of
- *           shares for the next one and asks it to print its information too.
+/** @brief   Print the name, type (share) and statistics of this data item.
+ *  @details This method prints the share's name, a word indicating that it
+ *           is a shared data item, as opposed to a queue, and its usage 
+ *           statistics, formatted to match similar printouts from other task
+ *           shares such as queues. The list of shares is walked by 
+ *           @c print_all_shares(), so this method only prints its own line.
  *  @param   printer Reference to a serial device on which to print the status
  */
 template <class DataType>
 void Share<DataType>::print_in_list (Print& printer)
 {
-    // Print this task's name and pad it to 16 characters
-    printer.printf ("%-16sshare\t", name);
+    // Print this share's name and pad it to 16 characters
+    printer.printf ("%-16s%-8s", name, "share");
+
+    // Print the statistics
+    print_stats (printer);
 
     // End the line
     printer << endl;
-
-    // Call the next item
-    if (p_next != NULL)
-    {
-        p_next->print_in_list (printer);
-    }
 }
 
 
@@ -0,0 +1,401 @@
+/** @file   topic.h
+ *  @brief  This file contains a publish/subscribe channel for passing the
+ *          latest value of some data from one task to any number of others.
+ *  @details A @c Topic<T> holds three copies of its message. The publishing
+ *           task fills in the copy which is neither the newest nor the one
+ *           before it, in place, and then makes it the newest; readers copy
+ *           the newest message out. Every message carries a sequence number
+ *           which counts up by one per publication, so each @c Subscriber<T>
+ *           can tell whether it has a new message, the same one as last time,
+ *           or whether messages were skipped while it wasn't looking. A
+ *           reader which only needs part of a large message can look at it
+ *           where it lies with @c Subscriber::peek() instead of copying it.
+ *
+ *           No critical sections are used. Each copy has its own sequence
+ *           word which is odd while that copy is being written; a reader
+ *           checks the word before and after copying the message and tries
+ *           again if it changed. Since the publisher always writes the oldest
+ *           copy, a reader only has to try again if it was held up for two
+ *           whole publications, so a high priority task is never blocked by
+ *           a low priority one. Each topic has only one publishing task.
+ *
+ *           Topics are kept in the same list as shares, so they are printed
+ *           by @c print_all_shares() along with their subscribers.
+ *
+ *           @section usage_topic Usage
+ *           Topics and their message types are declared in topics.h and
+ *           defined in topics.cpp. The publishing task fills in a message:
+ *           @code{.cpp}
+ *           DriveCommand& command = drive_command_topic.claim ();
+ *           command.enable = true;
+ *           ...
+ *           drive_command_topic.publish ();
+ *           @endcode
+ *           and each reading task makes its own subscriber:
+ *           @code{.cpp}
+ *           Subscriber<DriveCommand> commands (drive_command_topic, "Drive");
+ *           DriveCommand command;
+ *           ...
+ *           uint32_t fresh = commands.receive (command);
+ *           @endcode
+ *           or, to read a few fields without copying the whole message:
+ *           @code{.cpp}
+ *           uint8_t state;
+ *           commands.peek ([&] (const DriveCommand& newest)
+ *           {
+ *               state = newest.state;
+ *           });
+ *           @endcode
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ *  @date    18 Oct 2026 Subscribers can read a message in place with peek()
+ */
+
+
+#ifndef TOPIC_H
+#define TOPIC_H
+
+#include "baseshare.h"
+
+template <class DataType> class Topic;
+
+
+/** @brief   Class through which one task reads messages from a topic.
+ *  @details A subscriber belongs to one task, which keeps it for as long as
+ *           the task runs. It remembers the sequence number of the last
+ *           message it received and counts how many messages it got, how
+ *           many it missed and how many times it looked when there wasn't
+ *           anything new.
+ */
+template <class DataType> class Subscriber
+{
+    friend class Topic<DataType>;
+
+protected:
+    Topic<DataType>& topic;         ///< The topic being read
+    const char* name;               ///< Name shown in diagnostic printouts
+    uint32_t last_seq;              ///< Sequence number of the last message
+    uint32_t received;              ///< Number of new messages received
+    uint32_t skipped;               ///< Messages published but never seen
+    uint32_t repeats;               ///< Reads which found no new message
+    Subscriber<DataType>* p_next;   ///< Next subscriber to the same topic
+
+    // Counts a message as new, repeated or skipped
+    uint32_t count_sequence (uint32_t seq);
+
+public:
+    // Constructor which attaches this subscriber to a topic
+    Subscriber (Topic<DataType>& a_topic, const char* p_name);
+
+    // Copies the newest message and says how many have been published since
+    uint32_t receive (DataType& copy);
+
+    // Shows the newest message where it lies and says how many have been
+    // published since
+    template <class Visitor> uint32_t peek (Visitor visit);
+
+    /** @brief   Returns the sequence number of the last message received.
+     *  @details The first message on each topic has sequence number 1; zero
+     *           means nothing has been received yet.
+     */
+    uint32_t get_sequence (void) const
+    {
+        return last_seq;
+    }
+
+    /** @brief   Returns the number of messages this subscriber has missed.
+     */
+    uint32_t get_skipped (void) const
+    {
+        return skipped;
+    }
+};
+
+
+/** @brief   Class for the latest value of some data, published by one task
+ *           and read by any number of others.
+ */
+template <class DataType> class Topic : public BaseShare
+{
+    friend class Subscriber<DataType>;
+
+protected:
+    /// One copy of the message with the sequence word which guards it
+    struct Slot
+    {
+        uint32_t seq;               ///< Twice the sequence number, odd if busy
+        DataType data;              ///< The message itself
+    };
+
+    Slot slots[3];                  ///< Newest, previous and next messages
+    uint8_t newest;                 ///< Index of the newest message
+    uint8_t writing;                ///< Index of the slot being filled
+    uint32_t next_seq;              ///< Sequence number of the next message
+    Subscriber<DataType>* p_subscribers;    ///< Every reader of this topic
+
+    // Copies the newest message, returning its sequence number
+    uint32_t read (DataType& copy);
+
+    // Shows the newest message to a function, returning its sequence number
+    template <class Visitor> uint32_t read_in_place (Visitor visit);
+
+public:
+    // Constructor which makes an empty topic
+    Topic (const char* p_name = NULL);
+
+    // Gives the publisher the slot to fill in for the next message
+    DataType& claim (void);
+
+    // Makes the message filled in since claim() the newest one
+    void publish (void);
+
+    /** @brief   Publishes a copy of a message.
+     *  @details This is the same as filling in the slot from @c claim() and
+     *           calling @c publish(), for messages which are small enough
+     *           that the copy doesn't matter.
+     *  @param   message The message to publish
+     */
+    void publish (const DataType& message)
+    {
+        claim () = message;
+        publish ();
+    }
+
+    // Prints the topic's statistics and one line for each subscriber
+    void print_in_list (Print& printer);
+};
+
+
+/** @brief   Constructor which makes an empty topic.
+ *  @details All three slots start with a sequence word of zero, which
+ *           readers take to mean nothing has been published yet.
+ *  @param   p_name A name to be shown in the list of shares and topics
+ */
+template <class DataType>
+Topic<DataType>::Topic (const char* p_name)
+    : BaseShare (p_name), newest (0), writing (1), next_seq (1),
+      p_subscribers (NULL)
+{
+    for (uint8_t index = 0; index < 3; index++)
+    {
+        slots[index].seq = 0;
+    }
+}
+
+
+/** @brief   Gives the publisher the slot to fill in for the next message.
+ *  @details The slot after the newest one is always the oldest of the three,
+ *           so readers still copying the newest or the previous message are
+ *           not disturbed. Its sequence word is made odd before anything is
+ *           written, so a reader which is part way through copying it will
+ *           know to try again. The slot still holds whatever message was in
+ *           it before, not the newest one, so every field must be filled in.
+ *  @return  A reference to the message to fill in
+ */
+template <class DataType>
+DataType& Topic<DataType>::claim (void)
+{
+    writing = (newest + 1) % 3;
+    __atomic_store_n (&slots[writing].seq, 2 * next_seq - 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence (__ATOMIC_RELEASE);
+    return slots[writing].data;
+}
+
+
+/** @brief   Makes the message filled in since @c claim() the newest one.
+ *  @details The slot's sequence word is made even again, and then the slot
+ *           is made the newest, both with release ordering so that a reader
+ *           which sees either also sees the whole message.
+ */
+template <class DataType>
+void Topic<DataType>::publish (void)
+{
+    uint32_t start = share_cycle_count ();
+    __atomic_store_n (&slots[writing].seq, 2 * next_seq, __ATOMIC_RELEASE);
+    __atomic_store_n (&newest, writing, __ATOMIC_RELEASE);
+    next_seq++;
+    count_put (start);
+}
+
+
+/** @brief   Copies the newest message.
+ *  @param   copy Filled in with the message, if there is one
+ *  @return  The message's sequence number, or zero if nothing has been
+ *           published yet
+ */
+template <class DataType>
+uint32_t Topic<DataType>::read (DataType& copy)
+{
+    for (;;)
+    {
+        const Slot& slot = slots[__atomic_load_n (&newest, __ATOMIC_ACQUIRE)];
+        uint32_t before = __atomic_load_n (&slot.seq, __ATOMIC_ACQUIRE);
+        if (before == 0)
+        {
+            return 0;
+        }
+        if ((before & 1) == 0)
+        {
+            copy = slot.data;
+            __atomic_thread_fence (__ATOMIC_ACQUIRE);
+            if (__atomic_load_n (&slot.seq, __ATOMIC_RELAXED) == before)
+            {
+                return before / 2;
+            }
+        }
+        // The publisher got to this slot while it was being copied
+    }
+}
+
+
+/** @brief   Shows the newest message to a function without copying it.
+ *  @details The function is given a reference to the message in its slot.
+ *           The slot's sequence word is checked before and after, as in
+ *           @c read(); if the publisher got to the slot in between, the
+ *           function is called again with the newest message. It may
+ *           therefore be called more than once and must only copy out what
+ *           it needs, not act on it, and must not keep the reference.
+ *  @param   visit Function taking a <tt>const DataType&</tt>
+ *  @return  The message's sequence number, or zero if nothing has been
+ *           published yet, in which case @p visit isn't called
+ */
+template <class DataType>
+template <class Visitor>
+uint32_t Topic<DataType>::read_in_place (Visitor visit)
+{
+    for (;;)
+    {
+        const Slot& slot = slots[__atomic_load_n (&newest, __ATOMIC_ACQUIRE)];
+        uint32_t before = __atomic_load_n (&slot.seq, __ATOMIC_ACQUIRE);
+        if (before == 0)
+        {
+            return 0;
+        }
+        if ((before & 1) == 0)
+        {
+            visit ((const DataType&)slot.data);
+            __atomic_thread_fence (__ATOMIC_ACQUIRE);
+            if (__atomic_load_n (&slot.seq, __ATOMIC_RELAXED) == before)
+            {
+                return before / 2;
+            }
+        }
+        // The publisher got to this slot while it was being read
+    }
+}
+
+
+/** @brief   Prints the topic's statistics and one line for each subscriber.
+ *  @details The topic's line has the same columns as a share's, with the
+ *           reads of all its subscribers added up. Each subscriber's line
+ *           shows the messages it received, skipped, and the times it found
+ *           nothing new.
+ *  @param   printer Reference to a serial device on which to print
+ */
+template <class DataType>
+void Topic<DataType>::print_in_list (Print& printer)
+{
+    uint32_t reads = 0;
+    for (Subscriber<DataType>* p_sub = p_subscribers; p_sub != NULL;
+         p_sub = p_sub->p_next)
+    {
+        reads += p_sub->received + p_sub->repeats;
+    }
+    stats.get_count = reads;
+
+    printer.printf ("%-16s%-8s", name, "topic");
+    print_stats (printer);
+    printer << endl;
+
+    for (Subscriber<DataType>* p_sub = p_subscribers; p_sub != NULL;
+         p_sub = p_sub->p_next)
+    {
+        printer.printf ("  -> %-16s%8lu new%8lu skipped%8lu repeated",
+                        p_sub->name, (unsigned long)p_sub->received,
+                        (unsigned long)p_sub->skipped,
+                        (unsigned long)p_sub->repeats);
+        printer << endl;
+    }
+}
+
+
+/** @brief   Constructor which attaches this subscriber to a topic.
+ *  @details Subscribers may be made by tasks after the scheduler has
+ *           started, so the topic's list of subscribers is changed inside a
+ *           critical section.
+ *  @param   a_topic The topic to read
+ *  @param   p_name  Name of the reader, shown in diagnostic printouts
+ */
+template <class DataType>
+Subscriber<DataType>::Subscriber (Topic<DataType>& a_topic,
+                                  const char* p_name)
+    : topic (a_topic), name (p_name == NULL ? "(unnamed)" : p_name),
+      last_seq (0), received (0), skipped (0), repeats (0)
+{
+    SHARE_ENTER_CRITICAL ();
+    p_next = topic.p_subscribers;
+    topic.p_subscribers = this;
+    SHARE_EXIT_CRITICAL ();
+}
+
+
+/** @brief   Copies the newest message and says how many have been published
+ *           since the last call.
+ *  @details A result of 1 is the usual case of one new message. A result of
+ *           0 means the message is the same one as last time, so the data is
+ *           stale, or that nothing has been published yet, in which case
+ *           @p copy isn't changed. Larger results mean messages were
+ *           published which this subscriber never saw.
+ *  @param   copy Filled in with the newest message
+ *  @return  Number of messages published since the last call
+ */
+template <class DataType>
+uint32_t Subscriber<DataType>::receive (DataType& copy)
+{
+    return count_sequence (topic.read (copy));
+}
+
+
+/** @brief   Shows the newest message where it lies and says how many have
+ *           been published since the last call.
+ *  @details This is @c receive() for messages which are too large to copy
+ *           when only a few fields are wanted. See @c Topic::read_in_place()
+ *           for what @p visit may do; it isn't called if nothing has been
+ *           published yet.
+ *  @param   visit Function taking a <tt>const DataType&</tt>
+ *  @return  Number of messages published since the last call
+ */
+template <class DataType>
+template <class Visitor>
+uint32_t Subscriber<DataType>::peek (Visitor visit)
+{
+    return count_sequence (topic.read_in_place (visit));
+}
+
+
+/** @brief   Counts a message as new, repeated or skipped.
+ *  @param   seq Sequence number of the message just read
+ *  @return  Number of messages published since the last one read
+ */
+template <class DataType>
+uint32_t Subscriber<DataType>::count_sequence (uint32_t seq)
+{
+    uint32_t fresh = seq - last_seq;
+    if (fresh == 0)
+    {
+        repeats++;
+    }
+    else
+    {
+        received++;
+        skipped += fresh - 1;
+        last_seq = seq;
+    }
+    return fresh;
+}
+
+#endif //end if: define topic declarations
@@ -0,0 +1,22 @@
+/** @file   topics.cpp
+ *  @brief  This file contains the definitions of the topics which the
+ *          CleanBot's tasks use to pass messages to each other.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ */
+
+#include "topics.h"
+
+Topic<bool> run_topic ("Run");
+
+Topic<LineReading> line_topic ("Line");
+
+Topic<DriveCommand> drive_command_topic ("Drive Command");
+
+Topic<Odometry> odometry_topic ("Odometry");
+
+Topic<LampStatus> lamp_topic ("Lamp");
@@ -0,0 +1,70 @@
+/** @file   topics.h
+ *  @brief  This file declares the messages which the CleanBot's tasks pass
+ *          to each other and the topics they are published on.
+ *  @details Every topic in the system is declared here and defined in
+ *           topics.cpp, so a task only needs to include this file to use
+ *           any of them. See topic.h for how topics work.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ */
+
+
+#ifndef TOPICS_H
+#define TOPICS_H
+
+#include <stdint.h>
+#include "topic.h"
+#include "line_features.h"
+#include "odometry.h"
+
+/** @brief   What the IR array saw in one frame.
+ */
+struct LineReading
+{
+    uint8_t frame;                  ///< Sensor bits, bit 0 is sensor 1
+    LineFeatures features;          ///< Width, edges and kind of line
+    uint8_t drive_state;            ///< Drive state from track_line()
+};
+
+/** @brief   Everything the drive train needs for one cycle, published as one
+ *           message so it never mixes values from different decisions.
+ */
+struct DriveCommand
+{
+    bool enable;                    ///< True if the CleanBot may run
+    uint8_t state;                  ///< Drive state the speeds were chosen for
+    int16_t left_target;            ///< Speed for the left motor
+    int16_t right_target;           ///< Speed for the right motor
+};
+
+/** @brief   What the LED task is doing with the UV lamp.
+ */
+struct LampStatus
+{
+    bool lamp_on;                   ///< True while the lamp is lit
+    uint8_t speed_percent;          ///< Speed which gives the floor ahead the
+                                    ///< dose it still needs
+};
+
+/// Published by the WiFi task; true when the CleanBot has been told to run
+extern Topic<bool> run_topic;
+
+/// Published by the IR array task once per frame
+extern Topic<LineReading> line_topic;
+
+/// Published by the IR array task once per frame for the drive train
+extern Topic<DriveCommand> drive_command_topic;
+
+/// Published by the encoder task with the position worked out from the
+/// encoder counts
+extern Topic<Odometry> odometry_topic;
+
+/// Published by the LED task with the state of the lamp and the speed the
+/// coverage grid asks for
+extern Topic<LampStatus> lamp_topic;
+
+#endif //end if: define topic list
@@ -0,0 +1,305 @@
+/** @file   trace.cpp
+ *  @brief  This file contains the definitions of the trace writer and reader
+ *          used to record and replay CleanBot runs.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date   18 Oct 2026     File Created
+ *  @date   18 Oct 2026     Lamp records
+ *  @date   18 Oct 2026     First record timed from @c micros(); damaged
+ *                          traces are reported
+ */
+
+#include <string.h>
+#include "trace.h"
+
+/// Bytes which mark the start of a trace
+static const uint8_t TRACE_MAGIC[4] = {'C', 'B', 'T', 'R'};
+
+/// The largest record is a tag, a 5 byte time and two 5 byte integers
+static const uint8_t MAX_RECORD_SIZE = 16;
+
+
+/** @brief      Writes an unsigned variable length integer, 7 bits per byte
+ *  @return     The number of bytes written
+ */
+static uint8_t put_varint(uint8_t* p_out, uint32_t value)
+{
+    uint8_t count = 0;
+    while (value >= 0x80)
+    {
+        p_out[count++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    p_out[count++] = (uint8_t)value;
+    return count;
+}
+
+/** @brief      Maps signed integers to unsigned so small magnitudes stay short
+ */
+static uint32_t zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+/** @brief      Undoes zigzag()
+ */
+static int32_t unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+
+/** @brief      Constructor which starts a trace in the given buffer
+ *
+ *  @param      p_buffer    Memory to hold the trace
+ *  @param      buffer_size Number of bytes of memory at @c p_buffer
+ */
+TraceWriter::TraceWriter(uint8_t* p_buffer, size_t buffer_size)
+    : buffer(p_buffer), size(buffer_size)
+{
+    reset();
+}
+
+/** @brief      Throws away the recorded trace and starts a new one
+ */
+void TraceWriter::reset()
+{
+    used = 0;
+    last_time_us = 0;
+    last_left_count = 0;
+    last_right_count = 0;
+    started = false;
+    is_full = size < TRACE_HEADER_SIZE;
+
+    if (!is_full)
+    {
+        memcpy(buffer, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        buffer[4] = TRACE_VERSION;
+        used = TRACE_HEADER_SIZE;
+    }
+}
+
+/** @brief      Adds one record to the trace if all of it fits
+ *
+ *  @param      type            Kind of record
+ *  @param      time_us         Time stamp from @c micros()
+ *  @param      payload         Bytes which follow the time stamp
+ *  @param      payload_size    Number of payload bytes
+ *  @return     True if the record was written
+ */
+bool TraceWriter::add_record(TraceRecordType type, uint32_t time_us,
+                             const uint8_t* payload, uint8_t payload_size)
+{
+    if (is_full)
+    {
+        return false;
+    }
+
+    // The first record holds the whole time stamp, so a trace which follows
+    // another one carries on from where it left off
+    uint32_t delta = started ? time_us - last_time_us : time_us;
+
+    uint8_t record[MAX_RECORD_SIZE];
+    uint8_t record_size = 0;
+    record[record_size++] = type;
+    record_size += put_varint(record + record_size, delta);
+    memcpy(record + record_size, payload, payload_size);
+    record_size += payload_size;
+
+    if (used + record_size > size)
+    {
+        is_full = true;
+        return false;
+    }
+
+    memcpy(buffer + used, record, record_size);
+    used += record_size;
+    last_time_us = time_us;
+    started = true;
+    return true;
+}
+
+/** @brief      Records a frame read from the IR array
+ */
+bool TraceWriter::ir_frame(uint32_t time_us, uint8_t frame)
+{
+    return add_record(TRACE_IR_FRAME, time_us, &frame, 1);
+}
+
+/** @brief      Records the counts of both encoders as changes since the last
+ *              encoder record
+ */
+bool TraceWriter::encoders(uint32_t time_us, int32_t left_count,
+                           int32_t right_count)
+{
+    uint8_t payload[10];
+    uint8_t payload_size = 0;
+    payload_size += put_varint(payload + payload_size,
+                               zigzag(left_count - last_left_count));
+    payload_size += put_varint(payload + payload_size,
+                               zigzag(right_count - last_right_count));
+
+    if (!add_record(TRACE_ENCODERS, time_us, payload, payload_size))
+    {
+        return false;
+    }
+    last_left_count = left_count;
+    last_right_count = right_count;
+    return true;
+}
+
+/** @brief      Records the WiFi run/stop signal
+ */
+bool TraceWriter::wifi(uint32_t time_us, bool enable)
+{
+    uint8_t payload = enable ? 1 : 0;
+    return add_record(TRACE_WIFI, time_us, &payload, 1);
+}
+
+/** @brief      Records the speeds given to both motors
+ */
+bool TraceWriter::motors(uint32_t time_us, int16_t left_speed,
+                         int16_t right_speed)
+{
+    uint8_t payload[10];
+    uint8_t payload_size = 0;
+    payload_size += put_varint(payload + payload_size, zigzag(left_speed));
+    payload_size += put_varint(payload + payload_size, zigzag(right_speed));
+    return add_record(TRACE_MOTORS, time_us, payload, payload_size);
+}
+
+/** @brief      Records the UV lamp and the speed the coverage grid allows
+ */
+bool TraceWriter::lamp(uint32_t time_us, bool lamp_on, uint8_t speed_percent)
+{
+    uint8_t payload[2] = {(uint8_t)(lamp_on ? 1 : 0), speed_percent};
+    return add_record(TRACE_LAMP, time_us, payload, 2);
+}
+
+
+/** @brief      Constructor which prepares to read a trace from memory
+ *
+ *  @param      p_trace     The trace, starting with its header
+ *  @param      trace_size  Number of bytes in the trace
+ */
+TraceReader::TraceReader(const uint8_t* p_trace, size_t trace_size)
+    : buffer(p_trace), size(trace_size), position(TRACE_HEADER_SIZE),
+      time_us(0), left_count(0), right_count(0), is_damaged(false)
+{
+}
+
+/** @brief      Returns true if the trace starts with a header we understand
+ */
+bool TraceReader::valid() const
+{
+    return size >= TRACE_HEADER_SIZE
+        && memcmp(buffer, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0
+        && buffer[4] >= 1 && buffer[4] <= TRACE_VERSION;
+}
+
+/** @brief      Reads a variable length integer written by put_varint()
+ *  @return     False if the trace ends in the middle of the integer
+ */
+bool TraceReader::read_varint(uint32_t& value)
+{
+    value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7)
+    {
+        if (position >= size)
+        {
+            return false;
+        }
+        uint8_t byte = buffer[position++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief      Reads the next record
+ *
+ *  @param      event   Filled in with the record
+ *  @return     False at the end of the trace or if the trace is damaged
+ */
+bool TraceReader::next(TraceEvent& event)
+{
+    if (!valid() || is_damaged || position >= size)
+    {
+        return false;
+    }
+
+    // Once a record has started, running out of trace part way through it
+    // means the trace was cut off
+    is_damaged = true;
+    uint8_t tag = buffer[position++];
+    uint32_t delta;
+    if (!read_varint(delta))
+    {
+        return false;
+    }
+    time_us += delta;
+
+    event.type = (TraceRecordType)tag;
+    event.time_us = time_us;
+
+    uint32_t a, b;
+    switch (tag)
+    {
+        case TRACE_IR_FRAME:
+            if (position >= size)
+            {
+                return false;
+            }
+            event.frame = buffer[position++];
+            break;
+
+        case TRACE_WIFI:
+            if (position >= size)
+            {
+                return false;
+            }
+            event.wifi = buffer[position++] != 0;
+            break;
+
+        case TRACE_ENCODERS:
+            if (!read_varint(a) || !read_varint(b))
+            {
+                return false;
+            }
+            left_count += unzigzag(a);
+            right_count += unzigzag(b);
+            event.left = left_count;
+            event.right = right_count;
+            break;
+
+        case TRACE_MOTORS:
+            if (!read_varint(a) || !read_varint(b))
+            {
+                return false;
+            }
+            event.left = unzigzag(a);
+            event.right = unzigzag(b);
+            break;
+
+        case TRACE_LAMP:
+            if (position + 1 >= size)
+            {
+                return false;
+            }
+            event.lamp_on = buffer[position++] != 0;
+            event.speed_percent = buffer[position++];
+            break;
+
+        default:
+            // Unknown record; we can't tell how long it is, so stop here
+            return false;
+    }
+    is_damaged = false;
+    return true;
+}
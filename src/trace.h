@@ -0,0 +1,185 @@
+/** @file   trace.h
+ *  @brief  This file contains a compact binary format for recording what the
+ *          CleanBot sees and does, so a run can be replayed on a PC.
+ *  @details A trace is a short header followed by a list of records. Each
+ *           record is a one byte tag, the time in microseconds since the
+ *           previous record as a variable length integer, and a small payload:
+ *           - IR frame: the 8 bit frame from IR_Array::getFrame()
+ *           - Encoders: change in both encoder counts since the last encoder
+ *             record, zigzag encoded as variable length integers
+ *           - WiFi: one byte, 1 if the CleanBot has been told to run
+ *           - Motors: the signed speed given to both motors, zigzag encoded
+ *           - Lamp: two bytes, 1 if the UV lamp is lit and the percentage of
+ *             speed the coverage grid allows
+ *           A 5 ms IR frame takes 4 bytes, so a 16 kB buffer holds well over
+ *           ten seconds of driving. The writer and reader use no heap and no
+ *           hardware, so this file is shared by the firmware and host tools.
+ *
+ *  @author Weston Montgomery
+ *  @author Alex Haduong
+ *  @author Aris Recidoro
+ *
+ *  @date    18 Oct 2026 File Created
+ *  @date    18 Oct 2026 Lamp records, so a replay can slow down as the
+ *                       coverage grid did
+ *  @date    18 Oct 2026 Times counted from @c micros() rather than the first
+ *                       record, so dumps printed one after another line up;
+ *                       the reader tells a damaged trace from its end
+ */
+
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Number of bytes in the header at the start of every trace
+const size_t TRACE_HEADER_SIZE = 5;
+
+/// Version of the trace format written into the header; traces of the
+/// version before it have no lamp records but can still be read
+const uint8_t TRACE_VERSION = 2;
+
+/// The kinds of record which can be found in a trace
+enum TraceRecordType : uint8_t
+{
+    TRACE_IR_FRAME = 1,             ///< Frame read from the IR array
+    TRACE_ENCODERS = 2,             ///< Counts read from both encoders
+    TRACE_WIFI = 3,                 ///< State of the WiFi run/stop signal
+    TRACE_MOTORS = 4,               ///< Speeds given to both motors
+    TRACE_LAMP = 5                  ///< UV lamp and the speed it allows
+};
+
+/** @brief   One decoded record from a trace.
+ *  @details Only the fields which belong to @c type are meaningful. Encoder
+ *           counts are returned as running totals rather than as the deltas
+ *           stored in the trace.
+ */
+struct TraceEvent
+{
+    TraceRecordType type;           ///< Which kind of record this is
+    uint32_t time_us;               ///< Time stamp from @c micros(); in a
+                                    ///< version 1 trace, from the first record
+    uint8_t frame;                  ///< IR frame, for @c TRACE_IR_FRAME
+    bool wifi;                      ///< Run signal, for @c TRACE_WIFI
+    bool lamp_on;                   ///< Lamp lit, for @c TRACE_LAMP
+    uint8_t speed_percent;          ///< Speed allowed, for @c TRACE_LAMP
+    int32_t left;                   ///< Left encoder count or motor speed
+    int32_t right;                  ///< Right encoder count or motor speed
+};
+
+/** @brief   Class which writes trace records into a caller supplied buffer.
+ *  @details Records are written whole or not at all; once a record doesn't
+ *           fit, the writer is full and drops everything after it so the
+ *           trace stays readable. The writer is not thread safe, so callers
+ *           in different tasks must protect it with a critical section.
+ */
+class TraceWriter
+{
+private:
+
+uint8_t* buffer;                    ///< Memory the trace is written into
+size_t size;                        ///< Number of bytes in @c buffer
+size_t used;                        ///< Number of bytes written so far
+uint32_t last_time_us;              ///< Time stamp of the previous record
+int32_t last_left_count;            ///< Left encoder count last recorded
+int32_t last_right_count;           ///< Right encoder count last recorded
+bool started;                       ///< True once the first record is written
+bool is_full;                       ///< True once a record has been dropped
+
+bool add_record(TraceRecordType type, uint32_t time_us,
+                const uint8_t* payload, uint8_t payload_size);
+
+public:
+
+/** @brief      Constructor which starts a trace in the given buffer
+ *
+ *  @param      p_buffer    Memory to hold the trace
+ *  @param      buffer_size Number of bytes of memory at @c p_buffer
+ */
+TraceWriter(uint8_t* p_buffer, size_t buffer_size);
+
+/** @brief      Throws away the recorded trace and starts a new one
+ */
+void reset();
+
+/** @brief      Records a frame read from the IR array
+ */
+bool ir_frame(uint32_t time_us, uint8_t frame);
+
+/** @brief      Records the counts of both encoders
+ */
+bool encoders(uint32_t time_us, int32_t left_count, int32_t right_count);
+
+/** @brief      Records the WiFi run/stop signal
+ */
+bool wifi(uint32_t time_us, bool enable);
+
+/** @brief      Records the speeds given to both motors
+ */
+bool motors(uint32_t time_us, int16_t left_speed, int16_t right_speed);
+
+/** @brief      Records the UV lamp and the speed the coverage grid allows
+ */
+bool lamp(uint32_t time_us, bool lamp_on, uint8_t speed_percent);
+
+/** @brief      Returns the number of bytes of trace written so far
+ */
+size_t length() const { return used; }
+
+/** @brief      Returns a pointer to the start of the trace
+ */
+const uint8_t* data() const { return buffer; }
+
+/** @brief      Returns true once the buffer has filled and records are lost
+ */
+bool full() const { return is_full; }
+
+}; //end class TraceWriter
+
+
+/** @brief   Class which reads records back out of a trace.
+ */
+class TraceReader
+{
+private:
+
+const uint8_t* buffer;              ///< The trace being read
+size_t size;                        ///< Number of bytes in the trace
+size_t position;                    ///< Offset of the next record
+uint32_t time_us;                   ///< Time stamp of the previous record
+int32_t left_count;                 ///< Running left encoder count
+int32_t right_count;                ///< Running right encoder count
+bool is_damaged;                    ///< True once a bad record has been found
+
+bool read_varint(uint32_t& value);
+
+public:
+
+/** @brief      Constructor which prepares to read a trace from memory
+ *
+ *  @param      p_trace     The trace, starting with its header
+ *  @param      trace_size  Number of bytes in the trace
+ */
+TraceReader(const uint8_t* p_trace, size_t trace_size);
+
+/** @brief      Returns true if the trace starts with a header we understand
+ */
+bool valid() const;
+
+/** @brief      Reads the next record
+ *
+ *  @param      event   Filled in with the record
+ *  @return     False at the end of the trace or if the trace is damaged
+ */
+bool next(TraceEvent& event);
+
+/** @brief      Returns true if reading stopped at an unknown or cut off
+ *              record rather than at the end of the trace
+ */
+bool damaged() const { return is_damaged; }
+
+}; //end class TraceReader
+
+#endif //end if: define trace declarations